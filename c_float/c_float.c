@@ -13,21 +13,422 @@
 // ================================================================================
 // Include modules here
 
-#include <immintrin.h>  // AVX/SSE
 #include "c_float.h"
 #include <errno.h>
 #include <string.h>
 #include <float.h>
 #include <limits.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <math.h>
 #include <stdio.h>
+#include <time.h>
+
+// Dictionary seeds come from the kernel where it offers a call for them
+#if defined(__linux__)
+    #include <sys/random.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define C_FLOAT_X86
+    #include <immintrin.h>  // AVX/SSE
+#endif
+
+// GCC and Clang can compile each kernel for its own instruction set and pick
+// one at run time; other compilers only get the sets enabled on the command line
+#if defined(C_FLOAT_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define C_FLOAT_DISPATCH
+    #define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define SIMD_TARGET(isa)
+#endif
+
+// The worker pool needs POSIX threads; elsewhere parallel work runs serially
+#if !defined(_WIN32)
+    #define C_FLOAT_THREADS
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+// Saves write a temporary file, sync it and rename it over the target, which
+// is atomic where POSIX rename is available
+#if !defined(_WIN32)
+    #define C_FLOAT_ATOMIC_SAVE
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Large vector buffers live in anonymous mappings where the kernel can resize
+// them in place; that needs mremap, which only Linux provides
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #if defined(MREMAP_MAYMOVE)
+        #define C_FLOAT_MMAP
+    #endif
+#endif
 
 static const float LOAD_FACTOR_THRESHOLD = 0.7;
 static const size_t VEC_THRESHOLD = 1 * 1024 * 1024;  // 1 MB
 static const size_t VEC_FIXED_AMOUNT = 1 * 1024 * 1024;  // 1 MB
 static const size_t hashSize = 16;  //  Size fo hash map init functions
-static const uint32_t HASH_SEED = 0x45d9f3b; 
+// ================================================================================
+// ================================================================================ 
+// Vector buffers.  A buffer of at least the mmap threshold is an anonymous
+// mapping rather than a heap block.  The kernel hands out its pages already
+// zeroed, mremap grows it by moving page table entries instead of copying,
+// and transparent huge pages can be requested for it.
+
+#if defined(C_FLOAT_MMAP)
+static const size_t VEC_MMAP_THRESHOLD = 32 * 1024 * 1024;  // 32 MiB
+static size_t vec_mmap_threshold = VEC_MMAP_THRESHOLD;
+#endif
+static bool vec_huge_pages = true;
+// --------------------------------------------------------------------------------
+
+bool set_float_vector_mmap_threshold(size_t bytes) {
+#if defined(C_FLOAT_MMAP)
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(&vec_mmap_threshold, bytes, __ATOMIC_RELAXED);
+#else
+    vec_mmap_threshold = bytes;
+#endif
+    return true;
+#else
+    (void) bytes;
+    errno = ENOTSUP;
+    return false;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+size_t float_vector_mmap_threshold(void) {
+#if !defined(C_FLOAT_MMAP)
+    return SIZE_MAX;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(&vec_mmap_threshold, __ATOMIC_RELAXED);
+#else
+    return vec_mmap_threshold;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+void set_float_vector_huge_pages(bool enable) {
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(&vec_huge_pages, enable, __ATOMIC_RELAXED);
+#else
+    vec_huge_pages = enable;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool is_float_vector_mapped(const float_v* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return false;
+    }
+    return vec->mapped;
+}
+// --------------------------------------------------------------------------------
+
+#if defined(C_FLOAT_MMAP)
+static size_t _map_bytes(size_t slots) {
+    // Length of the mapping that holds slots floats
+    static size_t page;
+    if (page == 0) {
+        long size = sysconf(_SC_PAGESIZE);
+        page = size > 0 ? (size_t)size : 4096;
+    }
+    return (slots * sizeof(float) + page - 1) / page * page;
+}
+// --------------------------------------------------------------------------------
+
+static float* _buf_map(size_t slots) {
+    // Returns a zeroed mapping for slots floats, or NULL
+    if (slots == 0 || slots * sizeof(float) < float_vector_mmap_threshold()) {
+        return NULL;
+    }
+    size_t bytes = _map_bytes(slots);
+    void* ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+#if defined(MADV_HUGEPAGE)
+#if defined(__GNUC__) || defined(__clang__)
+    bool huge = __atomic_load_n(&vec_huge_pages, __ATOMIC_RELAXED);
+#else
+    bool huge = vec_huge_pages;
+#endif
+    // Advisory only; the mapping works the same if the kernel declines
+    if (huge) {
+        madvise(ptr, bytes, MADV_HUGEPAGE);
+    }
+#endif
+    return ptr;
+}
+#endif
+// --------------------------------------------------------------------------------
+
+static float* _buf_new(size_t slots, bool* mapped) {
+    // Returns a zeroed buffer for slots floats, or NULL
+    if (slots > SIZE_MAX / sizeof(float)) {
+        return NULL;
+    }
+#if defined(C_FLOAT_MMAP)
+    float* buf = _buf_map(slots);
+    if (buf) {
+        *mapped = true;
+        return buf;
+    }
+#endif
+    *mapped = false;
+    return calloc(slots, sizeof(float));
+}
+// --------------------------------------------------------------------------------
+
+static void _buf_free(float* buf, size_t slots, bool mapped) {
+#if defined(C_FLOAT_MMAP)
+    if (mapped) {
+        munmap(buf, _map_bytes(slots));
+        return;
+    }
+#else
+    (void) slots;
+    (void) mapped;
+#endif
+    free(buf);
+}
+// ================================================================================
+// ================================================================================ 
+// File-backed vectors.  The file starts with a 64 byte header followed by the
+// buffer, free front slots included, so the whole file maps onto a float_v
+// as it is.  The header is rewritten from the float_v when the vector is
+// synced, resized or freed.
+
+#define FLOAT_FILE_MAGIC "CFLOATV"
+#define FLOAT_FILE_VERSION 1u
+#define FLOAT_FILE_ENDIAN 0x01020304u
+#define FLOAT_FILE_INITIAL ((size_t)1008)  // Slots that fill the first page
+#define FLOAT_FILE_SORTED 1u               // flags bit for float_v.sorted
+
+typedef struct {
+    char magic[8];       // FLOAT_FILE_MAGIC
+    uint32_t version;    // FLOAT_FILE_VERSION
+    uint32_t endian;     // FLOAT_FILE_ENDIAN in the byte order of the writer
+    uint64_t len;        // float_v.len
+    uint64_t alloc;      // float_v.alloc
+    uint64_t front;      // float_v.front
+    uint64_t flags;      // FLOAT_FILE_SORTED
+    uint64_t reserved[2];
+} float_file_header;
+
+_Static_assert(sizeof(float_file_header) == 64, "float file header must be 64 bytes");
+
+struct float_file {
+    void* base;     // Start of the mapping
+    size_t bytes;   // Length of the mapping, and of the file while fd is open
+    int fd;         // -1 for views of a stored container, which need no file
+    bool writable;  // MAP_SHARED; otherwise a private copy-on-write mapping
+    size_t refs;    // Vectors and dictionaries that use the mapping
+};
+// --------------------------------------------------------------------------------
+
+#if defined(C_FLOAT_MMAP)
+static float_file_header* _file_header(const float_v* vec) {
+    return vec->file->base;
+}
+// --------------------------------------------------------------------------------
+
+static void _file_store_header(float_v* vec) {
+    float_file_header* header = _file_header(vec);
+    header->len = vec->len;
+    header->alloc = vec->alloc;
+    header->front = vec->front;
+    header->flags = vec->sorted ? FLOAT_FILE_SORTED : 0;
+}
+// --------------------------------------------------------------------------------
+
+static bool _file_resize(float_v* vec, size_t new_alloc) {
+    // Resizes the file, then the mapping, so every mapped page lies inside
+    // the file.  Bytes the file gains read as zero.
+    float_file* file = vec->file;
+    if (!file->writable) {
+        errno = EPERM;
+        return false;
+    }
+    if (vec->front + new_alloc > (SIZE_MAX - sizeof(float_file_header)) / sizeof(float)) {
+        errno = ERANGE;
+        return false;
+    }
+    size_t new_bytes = sizeof(float_file_header) + (vec->front + new_alloc) * sizeof(float);
+    if (new_bytes > file->bytes && ftruncate(file->fd, (off_t)new_bytes) != 0) {
+        return false;
+    }
+    void* ptr = mremap(file->base, file->bytes, new_bytes, MREMAP_MAYMOVE);
+    if (ptr == MAP_FAILED) {
+        if (new_bytes > file->bytes && ftruncate(file->fd, (off_t)file->bytes) != 0) {
+            // The file stays longer than the vector needs, which is harmless
+        }
+        errno = ENOMEM;
+        return false;
+    }
+    if (new_bytes < file->bytes && ftruncate(file->fd, (off_t)new_bytes) != 0) {
+        // As above; the mapping has already shrunk
+    }
+    file->base = ptr;
+    file->bytes = new_bytes;
+    vec->data = (float*)((char*)ptr + sizeof(float_file_header)) + vec->front;
+    vec->alloc = new_alloc;
+    _file_store_header(vec);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void _file_release(float_file* file) {
+    // Unmaps once the last vector or dictionary using the mapping lets go
+#if defined(__GNUC__) || defined(__clang__)
+    size_t refs = __atomic_sub_fetch(&file->refs, 1, __ATOMIC_ACQ_REL);
+#else
+    size_t refs = --file->refs;
+#endif
+    if (refs > 0) return;
+    munmap(file->base, file->bytes);
+    if (file->fd >= 0) close(file->fd);
+    free(file);
+}
+// --------------------------------------------------------------------------------
+
+static void _file_close(float_v* vec) {
+    if (vec->file->writable) {
+        _file_store_header(vec);
+    }
+    _file_release(vec->file);
+    vec->file = NULL;
+}
+#endif
+// --------------------------------------------------------------------------------
+
+float_v* open_float_vector_file(const char* path, bool writable) {
+#if defined(C_FLOAT_MMAP)
+    if (!path) {
+        errno = EINVAL;
+        return NULL;
+    }
+    int fd = open(path, writable ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    bool fresh = bytes == 0 && writable;
+    if (fresh) {
+        bytes = sizeof(float_file_header) + FLOAT_FILE_INITIAL * sizeof(float);
+        if (ftruncate(fd, (off_t)bytes) != 0) {
+            close(fd);
+            return NULL;
+        }
+    }
+    if (bytes < sizeof(float_file_header)) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+    // A read-only vector maps the file privately: writes to it stay in this
+    // process instead of faulting, and the file is never changed
+    void* base = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                      writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    float_file_header* header = base;
+    if (fresh) {
+        memcpy(header->magic, FLOAT_FILE_MAGIC, sizeof(FLOAT_FILE_MAGIC));
+        header->version = FLOAT_FILE_VERSION;
+        header->endian = FLOAT_FILE_ENDIAN;
+        header->len = 0;
+        header->alloc = FLOAT_FILE_INITIAL;
+        header->front = 0;
+        header->flags = FLOAT_FILE_SORTED;
+    }
+    // The payload must fit the file, and a file written on a host of the
+    // other byte order cannot be used in place
+    size_t slots = (bytes - sizeof(float_file_header)) / sizeof(float);
+    if (memcmp(header->magic, FLOAT_FILE_MAGIC, sizeof(FLOAT_FILE_MAGIC)) != 0 ||
+        header->version != FLOAT_FILE_VERSION || header->endian != FLOAT_FILE_ENDIAN ||
+        header->len > header->alloc || header->front > slots ||
+        header->alloc > slots - header->front) {
+        munmap(base, bytes);
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    float_v* vec = malloc(sizeof(float_v));
+    float_file* file = malloc(sizeof(float_file));
+    if (!vec || !file) {
+        free(vec);
+        free(file);
+        munmap(base, bytes);
+        close(fd);
+        errno = ENOMEM;
+        return NULL;
+    }
+    file->base = base;
+    file->bytes = bytes;
+    file->fd = fd;
+    file->writable = writable;
+    file->refs = 1;
+    vec->front = (size_t)header->front;
+    vec->data = (float*)((char*)base + sizeof(float_file_header)) + vec->front;
+    vec->len = (size_t)header->len;
+    vec->alloc = (size_t)header->alloc;
+    vec->alloc_type = DYNAMIC;
+    vec->sorted = vec->len <= 1 || (header->flags & FLOAT_FILE_SORTED);
+    vec->mapped = false;
+    vec->file = file;
+    return vec;
+#else
+    (void) path;
+    (void) writable;
+    errno = ENOTSUP;
+    return NULL;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool sync_float_vector_file(float_v* vec) {
+    if (!vec || !vec->data || !vec->file) {
+        errno = EINVAL;
+        return false;
+    }
+#if defined(C_FLOAT_MMAP)
+    if (!vec->file->writable) {
+        return true;
+    }
+    _file_store_header(vec);
+    return msync(_file_header(vec), vec->file->bytes, MS_SYNC) == 0;
+#else
+    return false;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+bool is_float_vector_file(const float_v* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return false;
+    }
+    return vec->file != NULL;
+}
 // ================================================================================
 // ================================================================================ 
 
@@ -42,20 +443,23 @@ float_v* init_float_vector(size_t buff) {
         return NULL;
     }
    
-    float* data_ptr = malloc(buff * sizeof(float));
+    // Initialize all elements
+    bool mapped = false;
+    float* data_ptr = _buf_new(buff, &mapped);
     if (data_ptr == NULL) {
         free(struct_ptr);
         errno = ENOMEM;
         return NULL; 
     }
    
-    // Initialize all elements
-    memset(data_ptr, 0, buff * sizeof(float));
-   
     struct_ptr->data = data_ptr;
     struct_ptr->len = 0;
     struct_ptr->alloc = buff;
+    struct_ptr->front = 0;
     struct_ptr->alloc_type = DYNAMIC;
+    struct_ptr->sorted = true;
+    struct_ptr->mapped = mapped;
+    struct_ptr->file = NULL;
     return struct_ptr;
 }
 // -------------------------------------------------------------------------------- 
@@ -65,6 +469,8 @@ float* c_float_ptr(float_v* vec) {
         errno = EINVAL;
         return NULL;
     }
+    // The caller may write through the pointer, so the order is no longer known
+    vec->sorted = vec->len <= 1;
     return vec->data;
 }
 // --------------------------------------------------------------------------------
@@ -74,7 +480,14 @@ void free_float_vector(float_v* vec) {
        errno = EINVAL;
        return;
    }
-   if (vec->data) free(vec->data);
+#if defined(C_FLOAT_MMAP)
+   if (vec->file) {
+       _file_close(vec);
+       free(vec);
+       return;
+   }
+#endif
+   if (vec->data) _buf_free(vec->data - vec->front, vec->front + vec->alloc, vec->mapped);
    free(vec);
 }
 // --------------------------------------------------------------------------------
@@ -87,38 +500,177 @@ void _free_float_vector(float_v** vec) {
 }
 // -------------------------------------------------------------------------------- 
 
-bool push_back_float_vector(float_v* vec, const float value) {
-    if (vec == NULL|| vec->data == NULL) {
-        errno = EINVAL;
+static inline bool _in_order(float a, float b) {
+    // True if b may follow a in ascending order with NaN values last
+    return isnan(b) || (!isnan(a) && a <= b);
+}
+// -------------------------------------------------------------------------------- 
+
+static size_t _grown_size(size_t size) {
+    // Doubles small buffers and adds a fixed amount to large ones
+    if (size == 0) {
+        return 1;
+    }
+    return size < VEC_THRESHOLD ? size * 2 : size + VEC_FIXED_AMOUNT;
+}
+// --------------------------------------------------------------------------------
+
+static bool _vec_resize(float_v* vec, size_t new_alloc) {
+    // Resizes the buffer so that new_alloc slots follow data, keeping the free
+    // slots before it.  Slots added at the end are zeroed.
+    if (new_alloc > SIZE_MAX / sizeof(float) - vec->front) {
+        errno = ERANGE;
         return false;
     }
-   
-    // Check if we need to resize
-    if (vec->len >= vec->alloc) {
-        if (vec->alloc_type == STATIC) {
-            errno = EINVAL;
+    float* base = vec->data - vec->front;
+    size_t old_alloc = vec->alloc;
+#if defined(C_FLOAT_MMAP)
+    if (vec->file) {
+        return _file_resize(vec, new_alloc);
+    }
+    size_t old_bytes = _map_bytes(vec->front + old_alloc);
+    size_t new_bytes = _map_bytes(vec->front + new_alloc);
+    if (vec->mapped) {
+        // Pages past the old end arrive zeroed, and the tail of the last old
+        // page is zero because slots past the elements always are
+        void* ptr = new_bytes == old_bytes ? base :
+                    mremap(base, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (ptr == MAP_FAILED) {
+            errno = ENOMEM;
             return false;
         }
-        size_t new_alloc = vec->alloc == 0 ? 1 : vec->alloc;
-        if (new_alloc < VEC_THRESHOLD) {
-            new_alloc *= 2;
-        } else {
-            new_alloc += VEC_FIXED_AMOUNT;
+        vec->data = (float*)ptr + vec->front;
+        vec->alloc = new_alloc;
+        return true;
+    }
+    if (new_alloc > old_alloc) {
+        // A heap buffer that crosses the threshold moves into a mapping once
+        float* map = _buf_map(vec->front + new_alloc);
+        if (map) {
+            memcpy(map + vec->front, vec->data, vec->len * sizeof(float));
+            free(base);
+            vec->data = map + vec->front;
+            vec->alloc = new_alloc;
+            vec->mapped = true;
+            return true;
         }
-       
-        // Allocate more space for the array of str structs
-        float* new_data = realloc(vec->data, new_alloc * sizeof(float));
-        if (!new_data) {
-            errno = ENOMEM;
+    }
+#endif
+    base = realloc(base, (vec->front + new_alloc) * sizeof(float));
+    if (!base) {
+        errno = ENOMEM;
+        return false;
+    }
+    vec->data = base + vec->front;
+    vec->alloc = new_alloc;
+    if (new_alloc > old_alloc) {
+        memset(vec->data + old_alloc, 0, (new_alloc - old_alloc) * sizeof(float));
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void _vec_compact(float_v* vec) {
+    // Moves the elements to the start of the buffer so the free slots before
+    // them follow them instead.  Slots outside the elements stay zeroed.
+    float* base = vec->data - vec->front;
+    memmove(base, vec->data, vec->len * sizeof(float));
+    memset(base + vec->len, 0, vec->front * sizeof(float));
+    vec->data = base;
+    vec->alloc += vec->front;
+    vec->front = 0;
+}
+// --------------------------------------------------------------------------------
+
+static bool _vec_reserve_back(float_v* vec) {
+    // Makes room for one more element after the last one
+    if (vec->len < vec->alloc) {
+        return true;
+    }
+    // A vector drained from the front, such as a FIFO queue, reuses the freed
+    // slots once they are as many as its elements, which bounds its buffer
+    // and keeps the move amortized O(1) per element
+    if (vec->front > 0 && (vec->alloc_type == STATIC || vec->front >= vec->len)) {
+        _vec_compact(vec);
+        return true;
+    }
+    if (vec->alloc_type == STATIC) {
+        errno = EINVAL;
+        return false;
+    }
+    // A mapping only reserves address space until pages are written, so it
+    // can always grow geometrically
+    size_t total = vec->front + vec->alloc;
+    bool sparse = vec->mapped || vec->file;
+    size_t new_total = sparse && total <= SIZE_MAX / 2 ? total * 2 : _grown_size(total);
+    return _vec_resize(vec, new_total - vec->front);
+}
+// --------------------------------------------------------------------------------
+
+static bool _vec_reserve_front(float_v* vec) {
+    // Makes room for one more element before the first one
+    if (vec->front > 0) {
+        return true;
+    }
+    size_t spare = vec->alloc - vec->len;
+    if (vec->file && spare < vec->len + 1) {
+        // A file only grows at its end; the shift below then opens the gap
+        if (!_vec_resize(vec, vec->alloc <= SIZE_MAX / 2 ? vec->alloc * 2 + 1 : SIZE_MAX)) {
             return false;
         }
-       
-        // Initialize new elements
-        memset(new_data + vec->alloc, 0, (new_alloc - vec->alloc) * sizeof(float));
-       
-        vec->data = new_data;
-        vec->alloc = new_alloc;
+        spare = vec->alloc - vec->len;
+    }
+    if (spare > 0 && (spare >= vec->len || vec->alloc_type == STATIC)) {
+        // Shifting by half of the spare slots pays for that many pushes
+        size_t shift = (spare + 1) / 2;
+        memmove(vec->data + shift, vec->data, vec->len * sizeof(float));
+        memset(vec->data, 0, shift * sizeof(float));
+        vec->data += shift;
+        vec->front = shift;
+        vec->alloc -= shift;
+        return true;
+    }
+    if (vec->alloc_type == STATIC) {
+        errno = EINVAL;
+        return false;
+    }
+    // Centre the elements in a larger buffer, copying them only once
+    size_t new_size = _grown_size(vec->alloc);
+    if (new_size > SIZE_MAX / sizeof(float)) {
+        errno = ERANGE;
+        return false;
+    }
+    bool mapped = false;
+    float* base = _buf_new(new_size, &mapped);
+    if (!base) {
+        errno = ENOMEM;
+        return false;
+    }
+    size_t shift = (new_size - vec->len + 1) / 2;
+    if (vec->len > 0) {
+        memcpy(base + shift, vec->data, vec->len * sizeof(float));
+    }
+    _buf_free(vec->data, vec->alloc, vec->mapped);
+    vec->mapped = mapped;
+    vec->data = base + shift;
+    vec->front = shift;
+    vec->alloc = new_size - shift;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool push_back_float_vector(float_v* vec, const float value) {
+    if (vec == NULL|| vec->data == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+   
+    // Check if we need to resize
+    if (!_vec_reserve_back(vec)) {
+        return false;
     }
+    vec->sorted = vec->len == 0 ||
+                  (vec->sorted && _in_order(vec->data[vec->len - 1], value));
     vec->data[vec->len] = value; 
     vec->len++;
    
@@ -131,50 +683,23 @@ bool push_front_float_vector(float_v* vec, const float value) {
         errno = EINVAL;
         return false;
     }
-   
-    // Check if we need to resize
-    if (vec->len >= vec->alloc) {
-        if (vec->alloc_type == STATIC) {
-            errno = EINVAL;
-            return false;
-        }
-        
-        size_t new_alloc = vec->alloc == 0 ? 1 : vec->alloc;
-        if (new_alloc < VEC_THRESHOLD) {
-            new_alloc *= 2;
-        } else {
-            new_alloc += VEC_FIXED_AMOUNT;
-        }
-        
-        // Check for size_t overflow
-        if (new_alloc > SIZE_MAX / sizeof(float)) {
-            errno = ERANGE;
-            return false;
-        }
-       
-        float* new_data = realloc(vec->data, new_alloc * sizeof(float));
-        if (!new_data) {
-            errno = ENOMEM;
-            return false;
-        }
-       
-        memset(new_data + vec->alloc, 0, (new_alloc - vec->alloc) * sizeof(float));
-       
-        vec->data = new_data;
-        vec->alloc = new_alloc;
-    }
 
     // Check for length overflow
     if (vec->len > SIZE_MAX - 1) {
         errno = ERANGE;
         return false;
     }
-    
-    // Move existing elements right if there are any
-    if (vec->len > 0) {
-        memmove(vec->data + 1, vec->data, vec->len * sizeof(float));
+
+    // Take a free slot before the first element, making one if necessary
+    if (!_vec_reserve_front(vec)) {
+        return false;
     }
     
+    vec->sorted = vec->len == 0 || (vec->sorted && _in_order(value, vec->data[0]));
+
+    vec->data--;
+    vec->front--;
+    vec->alloc++;
     vec->data[0] = value;    
     vec->len++;
     return true;
@@ -195,39 +720,26 @@ bool insert_float_vector(float_v* vec, float value, size_t index) {
         return false;
     }
    
+    // Elements before index can shift left into a free slot before data
+    bool shift_front = vec->front > 0 && index <= vec->len / 2;
+
     // Check if we need to resize
-    if (vec->len >= vec->alloc) {
-        if (vec->alloc_type == STATIC) {
-            errno = EINVAL;
-            return false;
-        }
-        size_t new_alloc = vec->alloc == 0 ? 1 : vec->alloc;
-        if (new_alloc < VEC_THRESHOLD) {
-            new_alloc *= 2;
-        } else {
-            new_alloc += VEC_FIXED_AMOUNT;
-        }
-        
-        // Check allocation size overflow
-        if (new_alloc > SIZE_MAX / sizeof(float)) {
-            errno = ERANGE;
-            return false;
-        }
-       
-        float* new_data = realloc(vec->data, new_alloc * sizeof(float));
-        if (!new_data) {
-            errno = ENOMEM;
-            return false;
-        }
-       
-        memset(new_data + vec->alloc, 0, (new_alloc - vec->alloc) * sizeof(float));
-       
-        vec->data = new_data;
-        vec->alloc = new_alloc;
+    if (!shift_front && !_vec_reserve_back(vec)) {
+        return false;
     }
     
+    vec->sorted = vec->len == 0 ||
+                  (vec->sorted && (index == 0 || _in_order(vec->data[index - 1], value)) &&
+                   (index == vec->len || _in_order(value, vec->data[index])));
+
+    if (shift_front) {
+        memmove(vec->data - 1, vec->data, index * sizeof(float));
+        vec->data--;
+        vec->front--;
+        vec->alloc++;
+    }
     // Move existing elements right
-    if (index < vec->len) {  // Only move if not appending
+    else if (index < vec->len) {  // Only move if not appending
         // Check for size_t overflow in move operation
         if (vec->len - index > SIZE_MAX - 1) {
             errno = ERANGE;
@@ -275,20 +787,13 @@ float pop_front_float_vector(float_v* vec) {  // Fixed function name
         return FLT_MAX;
     }
    
-    // Check for overflow in memmove size calculation
-    if (vec->len > SIZE_MAX / sizeof(float)) {
-        errno = ERANGE;
-        return FLT_MAX;
-    }
-   
     // Create copy of first element
     float temp = vec->data[0];
-    // Shift remaining elements left
-    memmove(vec->data, vec->data + 1, (vec->len - 1) * sizeof(float));
-   
-    // Clear the last element (which was moved)
-    memset(&vec->data[vec->len - 1], 0, sizeof(float));
-   
+    // Clear it and hand its slot to the free slots before data
+    vec->data[0] = 0.0f;
+    vec->data++;
+    vec->front++;
+    vec->alloc--;
     vec->len--;
     return temp;
 }
@@ -312,6 +817,17 @@ float pop_any_float_vector(float_v* vec, size_t index) {
     
     // Create copy of element to pop
     float temp = vec->data[index];
+
+    // Closer to the front, shift the elements before index right instead
+    if (index < vec->len / 2) {
+        memmove(vec->data + 1, vec->data, index * sizeof(float));
+        vec->data[0] = 0.0f;
+        vec->data++;
+        vec->front++;
+        vec->alloc--;
+        vec->len--;
+        return temp;
+    }
     
     // If not the last element, shift remaining elements left
     if (index < vec->len - 1) {
@@ -360,7 +876,7 @@ const size_t float_vector_alloc(const float_v* vec) {
         errno = EINVAL;
         return LONG_MAX;
     }
-    return vec->alloc;
+    return vec->alloc + vec->front;
 }
 // --------------------------------------------------------------------------------
 
@@ -382,6 +898,7 @@ void reverse_float_vector(float_v* vec) {
        i++;
        j--;
     }
+    vec->sorted = vec->len <= 1;
 }
 // ================================================================================
 // ================================================================================ 
@@ -419,62 +936,198 @@ static float* _median_of_three(float* a, float* b, float* c, iter_dir direction)
 }
 // -------------------------------------------------------------------------------- 
 
-static void _insertion_sort(float* vec, int low, int high, iter_dir direction) {
-    for (int i = low + 1; i <= high; i++) {
+static void _insertion_sort(float* vec, size_t low, size_t high, iter_dir direction) {
+    for (size_t i = low + 1; i <= high; i++) {
         float key = vec[i];
-        int j = i - 1;
-        while (j >= low && ((direction == FORWARD && vec[j] > key) ||
-                           (direction == REVERSE && vec[j] < key))) {
-            vec[j + 1] = vec[j];
+        size_t j = i;
+        while (j > low && ((direction == FORWARD && vec[j - 1] > key) ||
+                           (direction == REVERSE && vec[j - 1] < key))) {
+            vec[j] = vec[j - 1];
             j--;
         }
-        vec[j + 1] = key;
+        vec[j] = key;
     }
 }
 // --------------------------------------------------------------------------------
 
-static int _partition_float(float* vec, int low, int high, iter_dir direction) {
-    int mid = low + (high - low) / 2;
+static size_t _partition_float(float* vec, size_t low, size_t high, iter_dir direction) {
+    size_t mid = low + (high - low) / 2;
     float* pivot_ptr = _median_of_three(&vec[low], &vec[mid], &vec[high], direction);
     
     if (pivot_ptr != &vec[high])
         swap_float(pivot_ptr, &vec[high]);
     
     float pivot = vec[high];
-    int i = (low - 1);
+    size_t i = low;
     
-    for (int j = low; j <= high - 1; j++) {
+    for (size_t j = low; j < high; j++) {
         if ((direction == FORWARD && vec[j] < pivot) ||
             (direction == REVERSE && vec[j] > pivot)) {
-            i++;
             swap_float(&vec[i], &vec[j]);
+            i++;
         }
     }
-    swap_float(&vec[i + 1], &vec[high]);
-    return (i + 1);
+    swap_float(&vec[i], &vec[high]);
+    return i;
 }
 // -------------------------------------------------------------------------------- 
 
-static void _quicksort_float(float* vec, int low, int high, iter_dir direction) {
+static void _quicksort_float(float* vec, size_t low, size_t high, iter_dir direction) {
     while (low < high) {
         if (high - low < 10) {
             _insertion_sort(vec, low, high, direction);
             break;
         }
         
-        int pi = _partition_float(vec, low, high, direction);
+        size_t pi = _partition_float(vec, low, high, direction);
         
+        // Indices are unsigned, so an empty left side must not compute pi - 1
         if (pi - low < high - pi) {
-            _quicksort_float(vec, low, pi - 1, direction);
+            if (pi > low)
+                _quicksort_float(vec, low, pi - 1, direction);
             low = pi + 1;
         } else {
             _quicksort_float(vec, pi + 1, high, direction);
+            if (pi == low) break;
             high = pi - 1;
         }
     }
 }
 // -------------------------------------------------------------------------------- 
 
+static const size_t RADIX_THRESHOLD = 256;   // Shorter vectors use quicksort
+static const unsigned RADIX_BITS = 11;        // Three digit passes over 32 bit keys
+static const unsigned RADIX_PASSES = 3;
+static const size_t RADIX_BUCKETS = 2048;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Maps a float onto an unsigned key with the same ordering
+ *
+ * Positive values get the sign bit set and negative values are inverted, so
+ * the keys of -INFINITY through INFINITY increase monotonically.  XOR with
+ * flip (all ones for REVERSE) turns the ascending order into a descending one.
+ */
+static inline uint32_t _radix_key(float value, uint32_t flip) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t mask = (uint32_t)-(int32_t)(bits >> 31) | 0x80000000u;
+    return bits ^ mask ^ flip;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief LSD radix sort on the IEEE-754 bit pattern; data must be free of NaN
+ *
+ * One pass builds the histograms of all three digits, then each digit is
+ * scattered between data and scratch.  A digit shared by every element, such
+ * as the exponent of a narrow range of values, is skipped.  counts must hold
+ * RADIX_PASSES * RADIX_BUCKETS zeros.
+ *
+ * @return The buffer, data or scratch, that holds the sorted values
+ */
+static float* _radix_sort_buffers(float* data, float* scratch, size_t len,
+                                  iter_dir direction, size_t* counts) {
+    const uint32_t flip = direction == REVERSE ? UINT32_MAX : 0;
+    const uint32_t digit_mask = RADIX_BUCKETS - 1;
+    for (size_t i = 0; i < len; ++i) {
+        uint32_t key = _radix_key(data[i], flip);
+        counts[key & digit_mask]++;
+        counts[RADIX_BUCKETS + ((key >> RADIX_BITS) & digit_mask)]++;
+        counts[2 * RADIX_BUCKETS + (key >> (2 * RADIX_BITS))]++;
+    }
+
+    float* src = data;
+    float* dst = scratch;
+    for (unsigned pass = 0; pass < RADIX_PASSES; ++pass) {
+        size_t* count = counts + pass * RADIX_BUCKETS;
+        unsigned shift = pass * RADIX_BITS;
+        if (count[(_radix_key(src[0], flip) >> shift) & digit_mask] == len)
+            continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; ++b) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < len; ++i) {
+            float value = src[i];
+            dst[count[(_radix_key(value, flip) >> shift) & digit_mask]++] = value;
+        }
+        float* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    return src;
+}
+// -------------------------------------------------------------------------------- 
+
+static bool _radix_sort_float(float* data, size_t len, iter_dir direction) {
+    float* tmp = malloc(len * sizeof(float));
+    size_t* counts = calloc(RADIX_PASSES * RADIX_BUCKETS, sizeof(size_t));
+    if (!tmp || !counts) {
+        free(tmp);
+        free(counts);
+        errno = ENOMEM;
+        return false;
+    }
+
+    float* sorted = _radix_sort_buffers(data, tmp, len, direction, counts);
+    if (sorted != data)
+        memcpy(data, sorted, len * sizeof(float));
+    free(tmp);
+    free(counts);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Moves every NaN behind the numbers and returns the count of numbers
+ */
+static size_t _partition_nan(float* data, size_t len) {
+    size_t n = 0;
+    while (n < len && !isnan(data[n])) n++;
+    for (size_t i = n + 1; i < len; ++i) {
+        if (!isnan(data[i])) {
+            float temp = data[n];
+            data[n++] = data[i];
+            data[i] = temp;
+        }
+    }
+    return n;
+}
+// -------------------------------------------------------------------------------- 
+
+bool sort_float_vector_ex(float_v* vec, iter_dir direction, sort_mode mode) {
+    if (!vec || (!vec->data && vec->len > 0)) {
+        errno = EINVAL;
+        return false;
+    }
+    if ((direction != FORWARD && direction != REVERSE) ||
+        (mode != SORT_AUTO && mode != SORT_QUICK && mode != SORT_RADIX)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (vec->len < 2) {
+        vec->sorted = true;
+        return true;
+    }
+
+    size_t len = _partition_nan(vec->data, vec->len);
+    bool sorted = len < 2;
+    if (!sorted && (mode == SORT_RADIX || (mode == SORT_AUTO && len >= RADIX_THRESHOLD))) {
+        int saved = errno;
+        sorted = _radix_sort_float(vec->data, len, direction);
+        if (!sorted && mode == SORT_RADIX) return false;
+        if (!sorted) errno = saved;  // Out of scratch memory; quicksort needs none
+    }
+    if (!sorted) _quicksort_float(vec->data, 0, len - 1, direction);
+    vec->sorted = direction == FORWARD;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
 void sort_float_vector(float_v* vec, iter_dir direction) {
     if (!vec) {
         errno = EINVAL;
@@ -482,7 +1135,182 @@ void sort_float_vector(float_v* vec, iter_dir direction) {
     }
     if (vec->len < 2) return;
     
-    _quicksort_float(vec->data, 0, vec->len - 1, direction);
+    sort_float_vector_ex(vec, direction, SORT_AUTO);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Stable LSD radix sort of (key, index) pairs held in parallel arrays
+ *
+ * @return The index buffer, index or index_tmp, that holds the sorted order
+ */
+static size_t* _radix_sort_pairs(uint32_t* keys, size_t* index, uint32_t* keys_tmp,
+                                 size_t* index_tmp, size_t len, size_t* counts) {
+    const uint32_t digit_mask = RADIX_BUCKETS - 1;
+    for (size_t i = 0; i < len; ++i) {
+        uint32_t key = keys[i];
+        counts[key & digit_mask]++;
+        counts[RADIX_BUCKETS + ((key >> RADIX_BITS) & digit_mask)]++;
+        counts[2 * RADIX_BUCKETS + (key >> (2 * RADIX_BITS))]++;
+    }
+
+    for (unsigned pass = 0; pass < RADIX_PASSES; ++pass) {
+        size_t* count = counts + pass * RADIX_BUCKETS;
+        unsigned shift = pass * RADIX_BITS;
+        if (count[(keys[0] >> shift) & digit_mask] == len)
+            continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; ++b) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < len; ++i) {
+            size_t pos = count[(keys[i] >> shift) & digit_mask]++;
+            keys_tmp[pos] = keys[i];
+            index_tmp[pos] = index[i];
+        }
+        uint32_t* swap_keys = keys;
+        keys = keys_tmp;
+        keys_tmp = swap_keys;
+        size_t* swap_index = index;
+        index = index_tmp;
+        index_tmp = swap_index;
+    }
+    return index;
+}
+// -------------------------------------------------------------------------------- 
+
+size_t* argsort_float_vector(const float_v* vec, iter_dir direction) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (direction != FORWARD && direction != REVERSE) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t len = vec->len;
+    size_t* index = malloc(len * sizeof(size_t));
+    uint32_t* keys = malloc(len * sizeof(uint32_t));
+    if (!index || !keys) {
+        free(index);
+        free(keys);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    // NaN gets the largest key in both directions, so it sorts last
+    const uint32_t flip = direction == REVERSE ? UINT32_MAX : 0;
+    for (size_t i = 0; i < len; ++i) {
+        float value = vec->data[i];
+        keys[i] = isnan(value) ? UINT32_MAX : _radix_key(value, flip);
+        index[i] = i;
+    }
+
+    if (len < RADIX_THRESHOLD) {
+        for (size_t i = 1; i < len; ++i) {
+            uint32_t key = keys[i];
+            size_t idx = index[i];
+            size_t j = i;
+            while (j > 0 && keys[j - 1] > key) {
+                keys[j] = keys[j - 1];
+                index[j] = index[j - 1];
+                j--;
+            }
+            keys[j] = key;
+            index[j] = idx;
+        }
+        free(keys);
+        return index;
+    }
+
+    size_t* index_tmp = malloc(len * sizeof(size_t));
+    uint32_t* keys_tmp = malloc(len * sizeof(uint32_t));
+    size_t* counts = calloc(RADIX_PASSES * RADIX_BUCKETS, sizeof(size_t));
+    if (!index_tmp || !keys_tmp || !counts) {
+        free(index);
+        free(keys);
+        free(index_tmp);
+        free(keys_tmp);
+        free(counts);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    size_t* sorted = _radix_sort_pairs(keys, index, keys_tmp, index_tmp, len, counts);
+    free(sorted == index ? index_tmp : index);
+    free(keys);
+    free(keys_tmp);
+    free(counts);
+    return sorted;
+}
+// -------------------------------------------------------------------------------- 
+
+bool apply_permutation_float_vector(float_v** vecs, size_t count, const size_t* perm) {
+    if (!vecs || count == 0 || !perm) {
+        errno = EINVAL;
+        return false;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        if (!vecs[k] || !vecs[k]->data || vecs[k]->len != vecs[0]->len) {
+            errno = EINVAL;
+            return false;
+        }
+    }
+
+    size_t len = vecs[0]->len;
+    size_t words = (len + 63) / 64;
+    uint64_t* visited = calloc(words ? words : 1, sizeof(uint64_t));
+    float* carry = malloc(count * sizeof(float));
+    if (!visited || !carry) {
+        free(visited);
+        free(carry);
+        errno = ENOMEM;
+        return false;
+    }
+
+    // Reject anything that is not a permutation before touching the data
+    for (size_t i = 0; i < len; ++i) {
+        size_t p = perm[i];
+        if (p >= len || (visited[p / 64] >> (p % 64)) & 1) {
+            free(visited);
+            free(carry);
+            errno = EINVAL;
+            return false;
+        }
+        visited[p / 64] |= (uint64_t)1 << (p % 64);
+    }
+    memset(visited, 0, words * sizeof(uint64_t));
+
+    // Walk each cycle once, pulling element perm[j] into slot j in every vector
+    for (size_t start = 0; start < len; ++start) {
+        if ((visited[start / 64] >> (start % 64)) & 1) continue;
+        for (size_t k = 0; k < count; ++k)
+            carry[k] = vecs[k]->data[start];
+
+        size_t j = start;
+        for (;;) {
+            visited[j / 64] |= (uint64_t)1 << (j % 64);
+            size_t next = perm[j];
+            if (next == start) {
+                for (size_t k = 0; k < count; ++k)
+                    vecs[k]->data[j] = carry[k];
+                break;
+            }
+            for (size_t k = 0; k < count; ++k)
+                vecs[k]->data[j] = vecs[k]->data[next];
+            j = next;
+        }
+    }
+    for (size_t k = 0; k < count; ++k)
+        vecs[k]->sorted = len <= 1;
+
+    free(visited);
+    free(carry);
+    return true;
 }
 // -------------------------------------------------------------------------------- 
 
@@ -492,7 +1320,7 @@ void trim_float_vector(float_v* vec) {
         return;
     }
     
-    if (vec->alloc_type == STATIC || vec->len == vec->alloc) {
+    if (vec->alloc_type == STATIC || (vec->len == vec->alloc && vec->front == 0)) {
         return;
     }
    
@@ -507,14 +1335,11 @@ void trim_float_vector(float_v* vec) {
         return;
     }
     
-    float* ptr = realloc(vec->data, sizeof(float) * vec->len);
-    if (ptr == NULL) {
-        errno = ENOMEM;
-        return;
+    if (vec->front > 0) {
+        _vec_compact(vec);
     }
-    
-    vec->data = ptr;
-    vec->alloc = vec->len;
+    // A mapped buffer shrinks with mremap, returning its tail pages
+    _vec_resize(vec, vec->len);
 }
 // --------------------------------------------------------------------------------
 
@@ -539,8 +1364,8 @@ size_t binary_search_float_vector(float_v* vec, float value, float tolerance, bo
         return LONG_MAX;
     }
     
-    // Sort if requested and vector has more than 1 element
-    if (sort_first && vec->len > 1) {
+    // Sort if requested, unless the vector is known to be sorted already
+    if (sort_first && vec->len > 1 && !vec->sorted) {
         sort_float_vector(vec, FORWARD);
     }
     
@@ -571,449 +1396,3522 @@ size_t binary_search_float_vector(float_v* vec, float value, float tolerance, bo
 }
 // -------------------------------------------------------------------------------- 
 
-void update_float_vector(float_v* vec, size_t index, float replacement_value) {
-    if (!vec || !vec->data || vec->len == 0) {
+bool is_float_vector_sorted(const float_v* vec) {
+    if (!vec || !vec->data) {
         errno = EINVAL;
-        return;
-    }
-    if (index > vec->len -1) {
-        errno = ERANGE;
-        return;
+        return false;
     }
-    vec->data[index] = replacement_value;
+    return vec->sorted;
 }
 // -------------------------------------------------------------------------------- 
 
-float min_float_vector(float_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
-        errno = EINVAL;
-        return FLT_MAX;
-    }
-
-    float min_val = FLT_MAX;
-
-#if defined(__AVX__)
-    __m256 vmin = _mm256_set1_ps(min_val);
-    size_t i = 0;
+static size_t _bound_float(const float* data, size_t len, float value, bool upper) {
+    // Branchless binary search over ascending data with NaN values last.  The
+    // window halves every step and only its base moves, so the loop runs
+    // log2(len) times whatever the data and compiles to conditional moves.
+    if (len == 0) return 0;
+    const float* base = data;
+    size_t n = len;
+    while (n > 1) {
+        size_t half = n / 2;
+        float x = base[half - 1];
+        base += (upper ? x <= value : x < value) ? half : 0;
+        n -= half;
+    }
+    return (size_t)(base - data) + (upper ? *base <= value : *base < value);
+}
+// -------------------------------------------------------------------------------- 
 
-    for (; i + 7 < vec->len; i += 8) {
-        __m256 v = _mm256_loadu_ps(&vec->data[i]);
-        vmin = _mm256_min_ps(vmin, v);
+bool insert_sorted_float_vector(float_v* vec, float value) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return false;
     }
-
-    __m128 low = _mm256_castps256_ps128(vmin);
-    __m128 high = _mm256_extractf128_ps(vmin, 1);
-    __m128 min128 = _mm_min_ps(low, high);
-    min128 = _mm_min_ps(min128, _mm_movehl_ps(min128, min128));
-    min128 = _mm_min_ps(min128, _mm_shuffle_ps(min128, min128, 0x1));
-    min_val = _mm_cvtss_f32(min128);
-
-    for (; i < vec->len; ++i)
-        if (vec->data[i] < min_val)
-            min_val = vec->data[i];
-
-#elif defined(__SSE__)
-    __m128 vmin = _mm_set1_ps(min_val);
-    size_t i = 0;
-
-    for (; i + 3 < vec->len; i += 4) {
-        __m128 v = _mm_loadu_ps(&vec->data[i]);
-        vmin = _mm_min_ps(vmin, v);
+    if (!vec->sorted && vec->len > 0) {
+        errno = EINVAL;
+        return false;
     }
-
-    vmin = _mm_min_ps(vmin, _mm_movehl_ps(vmin, vmin));
-    vmin = _mm_min_ps(vmin, _mm_shuffle_ps(vmin, vmin, 0x1));
-    min_val = _mm_cvtss_f32(vmin);
-
-    for (; i < vec->len; ++i)
-        if (vec->data[i] < min_val)
-            min_val = vec->data[i];
-
-#else
-    for (size_t i = 0; i < vec->len; ++i)
-        if (vec->data[i] < min_val)
-            min_val = vec->data[i];
-#endif
-
-    return min_val;
+    // After any equal values, so repeated inserts keep their arrival order
+    size_t index = isnan(value) ? vec->len : _bound_float(vec->data, vec->len, value, true);
+    return insert_float_vector(vec, value, index);
 }
-
 // -------------------------------------------------------------------------------- 
 
-float max_float_vector(float_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
+static bool _check_sorted_query(const float_v* vec, float value) {
+    if (!vec || !vec->data || isnan(value)) {
         errno = EINVAL;
-        return FLT_MAX;
+        return false;
+    }
+    if (!vec->sorted && vec->len > 1) {
+        errno = EINVAL;
+        return false;
     }
+    return true;
+}
+// -------------------------------------------------------------------------------- 
 
-    float max_val = -FLT_MAX;
+size_t lower_bound_float_vector(const float_v* vec, float value) {
+    if (!_check_sorted_query(vec, value)) return LONG_MAX;
+    return _bound_float(vec->data, vec->len, value, false);
+}
+// -------------------------------------------------------------------------------- 
 
-#if defined(__AVX__)
-    __m256 vmax = _mm256_set1_ps(max_val);
-    size_t i = 0;
+size_t upper_bound_float_vector(const float_v* vec, float value) {
+    if (!_check_sorted_query(vec, value)) return LONG_MAX;
+    return _bound_float(vec->data, vec->len, value, true);
+}
+// -------------------------------------------------------------------------------- 
 
-    for (; i + 7 < vec->len; i += 8) {
-        __m256 v = _mm256_loadu_ps(&vec->data[i]);
-        vmax = _mm256_max_ps(vmax, v);
+size_t count_range_float_vector(const float_v* vec, float low, float high) {
+    if (!_check_sorted_query(vec, low) || !_check_sorted_query(vec, high)) {
+        return LONG_MAX;
     }
+    if (low > high) return 0;
+    return _bound_float(vec->data, vec->len, high, true) -
+           _bound_float(vec->data, vec->len, low, false);
+}
+// -------------------------------------------------------------------------------- 
 
-    __m128 low = _mm256_castps256_ps128(vmax);
-    __m128 high = _mm256_extractf128_ps(vmax, 1);
-    __m128 max128 = _mm_max_ps(low, high);
-    max128 = _mm_max_ps(max128, _mm_movehl_ps(max128, max128));
-    max128 = _mm_max_ps(max128, _mm_shuffle_ps(max128, max128, 0x1));
-    max_val = _mm_cvtss_f32(max128);
+#if defined(__GNUC__) || defined(__clang__)
+    #define FLOAT_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+    #define FLOAT_PREFETCH(addr) ((void)0)
+#endif
 
-    for (; i < vec->len; ++i)
-        if (vec->data[i] > max_val)
-            max_val = vec->data[i];
+// Queries descending the tree together in batch_search_float_index
+#define SEARCH_BATCH 16
 
-#elif defined(__SSE__)
-    __m128 vmax = _mm_set1_ps(max_val);
-    size_t i = 0;
+struct float_search_index {
+    size_t len;     // Number of values
+    size_t levels;  // Complete tree levels; every descent takes at least this many steps
+    float* tree;    // Values in 1-based Eytzinger order, tree[0] unused
+    size_t* rank;   // rank[k] is the sorted position of tree[k]; rank[0] == len
+};
+// -------------------------------------------------------------------------------- 
 
-    for (; i + 3 < vec->len; i += 4) {
-        __m128 v = _mm_loadu_ps(&vec->data[i]);
-        vmax = _mm_max_ps(vmax, v);
+static size_t _eytz_fill(const float* src, float* tree, size_t* rank, size_t i,
+                         size_t k, size_t n) {
+    // An in-order walk of the implicit tree visits the nodes in sorted order
+    if (k <= n) {
+        i = _eytz_fill(src, tree, rank, i, 2 * k, n);
+        tree[k] = src[i];
+        rank[k] = i++;
+        i = _eytz_fill(src, tree, rank, i, 2 * k + 1, n);
     }
+    return i;
+}
+// -------------------------------------------------------------------------------- 
 
-    vmax = _mm_max_ps(vmax, _mm_movehl_ps(vmax, vmax));
-    vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, 0x1));
-    max_val = _mm_cvtss_f32(vmax);
-
-    for (; i < vec->len; ++i)
-        if (vec->data[i] > max_val)
-            max_val = vec->data[i];
-
+static inline size_t _eytz_resolve(size_t k) {
+    // The descent ends below a leaf.  The answer is the last node where it
+    // went left, found by dropping the trailing right turns and one more bit;
+    // 0 if it never went left.
+#if defined(__GNUC__) || defined(__clang__)
+    return k >> (__builtin_ctzll(~(unsigned long long)k) + 1);
 #else
-    for (size_t i = 0; i < vec->len; ++i)
-        if (vec->data[i] > max_val)
-            max_val = vec->data[i];
+    while (k & 1) k >>= 1;
+    return k >> 1;
 #endif
-
-    return max_val;
 }
-
 // -------------------------------------------------------------------------------- 
 
-float sum_float_vector(float_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
-        errno = EINVAL;
-        return FLT_MAX;
+static inline size_t _eytz_go_right(float node, float value, float tolerance,
+                                    search_query query) {
+    switch (query) {
+        case SEARCH_LOWER_BOUND: return node < value;
+        case SEARCH_UPPER_BOUND: return node <= value;
+        // fl(node - value) is monotonic in node, so the first node with
+        // node - value >= -tolerance is the first possible match
+        default: return node - value < -tolerance;
     }
+}
+// -------------------------------------------------------------------------------- 
 
-    const size_t len = vec->len;
-    const float* data = vec->data;
-
-    float sum = 0.0f;
+static inline size_t _eytz_descend(const float_search_index* index, float value,
+                                   float tolerance, search_query query) {
+    const float* tree = index->tree;
+    const size_t n = index->len;
+    size_t k = 1;
+    while (k <= n) {
+        // 16 floats fill a cache line, so tree[16k] starts the line holding
+        // the descendants four levels down
+        size_t ahead = 16 * k;
+        FLOAT_PREFETCH(tree + (ahead <= n ? ahead : n));
+        k = 2 * k + _eytz_go_right(tree[k], value, tolerance, query);
+    }
+    return _eytz_resolve(k);
+}
+// -------------------------------------------------------------------------------- 
 
-#if defined(__AVX__)
-    __m256 vsum = _mm256_setzero_ps();
-    size_t i = 0;
+static inline size_t _eytz_answer(const float_search_index* index, size_t k, float value,
+                                  float tolerance, search_query query) {
+    if (query != SEARCH_TOLERANCE) return index->rank[k];
+    if (k != 0 && fabs(index->tree[k] - value) <= tolerance) return index->rank[k];
+    return LONG_MAX;
+}
+// -------------------------------------------------------------------------------- 
 
-    for (; i + 7 < len; i += 8) {
-        __m256 chunk = _mm256_loadu_ps(&data[i]);
-        vsum = _mm256_add_ps(vsum, chunk);
+float_search_index* init_float_search_index(const float_v* vec) {
+    if (!vec || !vec->data) {
+        errno = EINVAL;
+        return NULL;
     }
-
-    // Horizontal sum of vsum
-    __m128 low  = _mm256_castps256_ps128(vsum);         // lower 128
-    __m128 high = _mm256_extractf128_ps(vsum, 1);       // upper 128
-    __m128 sum128 = _mm_add_ps(low, high);              // add lower + upper
-
-    // Shuffle and reduce
-    sum128 = _mm_hadd_ps(sum128, sum128);
-    sum128 = _mm_hadd_ps(sum128, sum128);
-    sum += _mm_cvtss_f32(sum128);
-
-    // Handle remaining elements
-    for (; i < len; ++i) {
-        sum += data[i];
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return NULL;
     }
-
-#elif defined(__SSE__)
-    __m128 vsum = _mm_setzero_ps();
-    size_t i = 0;
-
-    for (; i + 3 < len; i += 4) {
-        __m128 chunk = _mm_loadu_ps(&data[i]);
-        vsum = _mm_add_ps(vsum, chunk);
+    // A vector known to be sorted only needs checking for trailing NaN values;
+    // otherwise the negated test also rejects NaN, which has no place in the order
+    if (isnan(vec->data[0]) || isnan(vec->data[vec->len - 1])) {
+        errno = EINVAL;
+        return NULL;
     }
-
-    vsum = _mm_hadd_ps(vsum, vsum);
-    vsum = _mm_hadd_ps(vsum, vsum);
-    sum += _mm_cvtss_f32(vsum);
-
-    for (; i < len; ++i) {
-        sum += data[i];
+    for (size_t i = 1; i < vec->len && !vec->sorted; i++) {
+        if (!(vec->data[i - 1] <= vec->data[i])) {
+            errno = EINVAL;
+            return NULL;
+        }
+    }
+    if (vec->len >= SIZE_MAX / sizeof(size_t)) {
+        errno = ENOMEM;
+        return NULL;
     }
 
-#else
-    // Fallback to scalar
-    for (size_t i = 0; i < len; ++i) {
-        sum += data[i];
+    float_search_index* index = malloc(sizeof(float_search_index));
+    if (!index) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    index->tree = malloc((vec->len + 1) * sizeof(float));
+    index->rank = malloc((vec->len + 1) * sizeof(size_t));
+    if (!index->tree || !index->rank) {
+        free(index->tree);
+        free(index->rank);
+        free(index);
+        errno = ENOMEM;
+        return NULL;
     }
-#endif
 
-    return sum;
+    index->len = vec->len;
+    index->levels = 0;
+    while (((size_t)2 << index->levels) - 1 <= vec->len) index->levels++;
+    index->tree[0] = 0.0f;
+    index->rank[0] = vec->len;
+    _eytz_fill(vec->data, index->tree, index->rank, 0, 1, vec->len);
+    return index;
 }
-
 // -------------------------------------------------------------------------------- 
 
-float average_float_vector(float_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
+void free_float_search_index(float_search_index* index) {
+    if (!index) {
         errno = EINVAL;
-        return FLT_MAX;
+        return;
     }
-
-    float sum = sum_float_vector(vec);
-    if (errno != 0) return FLT_MAX;
-    return sum / vec->len;
+    free(index->tree);
+    free(index->rank);
+    free(index);
 }
+// -------------------------------------------------------------------------------- 
 
+void _free_float_search_index(float_search_index** index) {
+    if (index && *index) {
+        free_float_search_index(*index);
+        *index = NULL;
+    }
+}
 // -------------------------------------------------------------------------------- 
 
-float stdev_float_vector(float_v* vec) {
-    if (!vec || !vec->data) {
-        errno = ENODATA;
-        return FLT_MAX;
+size_t float_search_index_size(const float_search_index* index) {
+    if (!index) {
+        errno = EINVAL;
+        return LONG_MAX;
     }
+    return index->len;
+}
+// -------------------------------------------------------------------------------- 
 
-    if (vec->len == 0) {
-        errno = ENODATA;
-        return FLT_MAX;
+size_t lower_bound_float_index(const float_search_index* index, float value) {
+    if (!index || isnan(value)) {
+        errno = EINVAL;
+        return LONG_MAX;
     }
+    return index->rank[_eytz_descend(index, value, 0.0f, SEARCH_LOWER_BOUND)];
+}
+// -------------------------------------------------------------------------------- 
 
-    if (vec->len == 1) {
-        errno = ENODATA;
-        return FLT_MAX;
+size_t upper_bound_float_index(const float_search_index* index, float value) {
+    if (!index || isnan(value)) {
+        errno = EINVAL;
+        return LONG_MAX;
     }
+    return index->rank[_eytz_descend(index, value, 0.0f, SEARCH_UPPER_BOUND)];
+}
+// -------------------------------------------------------------------------------- 
 
-    float mean = average_float_vector(vec);
-    if (errno != 0) return FLT_MAX;
-
-    float sum_sq_diff = 0.0f;
+size_t search_float_index(const float_search_index* index, float value, float tolerance) {
+    if (!index || isnan(value) || isnan(tolerance) || tolerance < 0) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    size_t k = _eytz_descend(index, value, tolerance, SEARCH_TOLERANCE);
+    return _eytz_answer(index, k, value, tolerance, SEARCH_TOLERANCE);
+}
+// -------------------------------------------------------------------------------- 
 
-#if defined(__AVX__)
-    __m256 vmean = _mm256_set1_ps(mean);
-    __m256 vsum = _mm256_setzero_ps();
-    size_t i = 0;
+bool batch_search_float_index(const float_search_index* index, const float_v* queries,
+                              search_query query, float tolerance, size_t* results) {
+    if (!index || !queries || !queries->data || !results) {
+        errno = EINVAL;
+        return false;
+    }
+    if (query != SEARCH_LOWER_BOUND && query != SEARCH_UPPER_BOUND &&
+        query != SEARCH_TOLERANCE) {
+        errno = EINVAL;
+        return false;
+    }
+    if (query == SEARCH_TOLERANCE && (isnan(tolerance) || tolerance < 0)) {
+        errno = EINVAL;
+        return false;
+    }
 
-    for (; i + 7 < vec->len; i += 8) {
-        __m256 v = _mm256_loadu_ps(&vec->data[i]);
-        __m256 diff = _mm256_sub_ps(v, vmean);
-        __m256 sq = _mm256_mul_ps(diff, diff);
-        if (!_mm256_testz_ps(sq, sq)) { // Skip all-zero check — we need isinf
-            for (int j = 0; j < 8; ++j) {
-                float x = vec->data[i + j];
-                if (isinf(x)) return INFINITY;
+    const float* tree = index->tree;
+    const size_t n = index->len;
+    size_t k[SEARCH_BATCH];
+    for (size_t start = 0; start < queries->len; start += SEARCH_BATCH) {
+        const float* values = queries->data + start;
+        size_t count = queries->len - start;
+        if (count > SEARCH_BATCH) count = SEARCH_BATCH;
+
+        // The complete levels are walked by the whole group in lockstep, so
+        // the loads of one level are all in flight at once
+        for (size_t j = 0; j < count; j++) k[j] = 1;
+        for (size_t level = 0; level < index->levels; level++) {
+            for (size_t j = 0; j < count; j++) {
+                size_t ahead = 16 * k[j];
+                FLOAT_PREFETCH(tree + (ahead <= n ? ahead : n));
+                k[j] = 2 * k[j] + _eytz_go_right(tree[k[j]], values[j], tolerance, query);
+            }
+        }
+        for (size_t j = 0; j < count; j++) {
+            if (k[j] <= n) {
+                k[j] = 2 * k[j] + _eytz_go_right(tree[k[j]], values[j], tolerance, query);
             }
+            results[start + j] = isnan(values[j]) ? LONG_MAX :
+                _eytz_answer(index, _eytz_resolve(k[j]), values[j], tolerance, query);
         }
-        vsum = _mm256_add_ps(vsum, sq);
     }
+    return true;
+}
+// -------------------------------------------------------------------------------- 
 
-    __m128 low = _mm256_castps256_ps128(vsum);
-    __m128 high = _mm256_extractf128_ps(vsum, 1);
-    __m128 sum128 = _mm_add_ps(low, high);
-    sum128 = _mm_hadd_ps(sum128, sum128);
-    sum128 = _mm_hadd_ps(sum128, sum128);
-    sum_sq_diff += _mm_cvtss_f32(sum128);
-
-    for (; i < vec->len; ++i) {
-        float diff = vec->data[i] - mean;
-        float sq = diff * diff;
-        if (isinf(vec->data[i])) return INFINITY;
-        sum_sq_diff += sq;
+void update_float_vector(float_v* vec, size_t index, float replacement_value) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return;
+    }
+    if (index > vec->len -1) {
+        errno = ERANGE;
+        return;
     }
+    vec->sorted = vec->sorted &&
+                  (index == 0 || _in_order(vec->data[index - 1], replacement_value)) &&
+                  (index == vec->len - 1 || _in_order(replacement_value, vec->data[index + 1]));
+    vec->data[index] = replacement_value;
+}
+// ================================================================================
+// ================================================================================
+// SIMD KERNELS AND RUNTIME DISPATCH
+//
+// Every reduction is written once per instruction set against a raw
+// (data, len) range.  The instruction set is chosen at run time from the
+// capabilities of the host CPU, so the library can be compiled for a generic
+// target and still use AVX2 or AVX-512 where the hardware provides them.
 
-#elif defined(__SSE__)
-    __m128 vmean = _mm_set1_ps(mean);
-    __m128 vsum = _mm_setzero_ps();
-    size_t i = 0;
+static float _min_scalar(const float* data, size_t len) {
+    float min_val = FLT_MAX;
+    for (size_t i = 0; i < len; ++i)
+        if (data[i] < min_val)
+            min_val = data[i];
+    return min_val;
+}
+// -------------------------------------------------------------------------------- 
 
-    for (; i + 3 < vec->len; i += 4) {
-        __m128 v = _mm_loadu_ps(&vec->data[i]);
-        __m128 diff = _mm_sub_ps(v, vmean);
-        __m128 sq = _mm_mul_ps(diff, diff);
-        for (int j = 0; j < 4; ++j) {
-            if (isinf(vec->data[i + j])) return INFINITY;
+static float _max_scalar(const float* data, size_t len) {
+    float max_val = -FLT_MAX;
+    for (size_t i = 0; i < len; ++i)
+        if (data[i] > max_val)
+            max_val = data[i];
+    return max_val;
+}
+// -------------------------------------------------------------------------------- 
+
+static float _sum_scalar(const float* data, size_t len) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < len; ++i)
+        sum += data[i];
+    return sum;
+}
+// -------------------------------------------------------------------------------- 
+
+// Neumaier's variant of Kahan summation also compensates when the incoming
+// term is larger than the running sum.  Once the sum overflows or meets an
+// infinity the compensation would be inf - inf, so it is only updated while
+// the sum is finite.
+static float _sum_kahan_scalar(const float* data, size_t len) {
+    float sum = 0.0f;
+    float comp = 0.0f;
+    for (size_t i = 0; i < len; ++i) {
+        float t = sum + data[i];
+        if (isfinite(t)) {
+            if (fabsf(sum) >= fabsf(data[i]))
+                comp += (sum - t) + data[i];
+            else
+                comp += (data[i] - t) + sum;
         }
-        vsum = _mm_add_ps(vsum, sq);
+        sum = t;
     }
+    return sum + comp;
+}
+// -------------------------------------------------------------------------------- 
 
-    vsum = _mm_hadd_ps(vsum, vsum);
-    vsum = _mm_hadd_ps(vsum, vsum);
-    sum_sq_diff += _mm_cvtss_f32(vsum);
+static float _sum_double_scalar(const float* data, size_t len) {
+    double sum = 0.0;
+    for (size_t i = 0; i < len; ++i)
+        sum += data[i];
+    return (float)sum;
+}
+// -------------------------------------------------------------------------------- 
 
-    for (; i < vec->len; ++i) {
-        if (isinf(vec->data[i])) return INFINITY;
-        float diff = vec->data[i] - mean;
+static float _sum_sq_diff_scalar(const float* data, size_t len, float mean) {
+    float sum_sq_diff = 0.0f;
+    for (size_t i = 0; i < len; ++i) {
+        if (isinf(data[i])) return INFINITY;
+        float diff = data[i] - mean;
         sum_sq_diff += diff * diff;
     }
+    return sum_sq_diff;
+}
+// -------------------------------------------------------------------------------- 
 
-#else
-    for (size_t i = 0; i < vec->len; ++i) {
-        if (isinf(vec->data[i])) return INFINITY;
-        float diff = vec->data[i] - mean;
-        sum_sq_diff += diff * diff;
-    }
-#endif
+/**
+ * @brief Streaming accumulator behind describe_float_vector
+ *
+ * Moments are kept in double precision and only cover finite values;
+ * NaNs are counted and skipped, infinities are counted and folded into
+ * min and max.  Two accumulators can be merged with Chan's formula, so a
+ * buffer may be reduced in any number of independent pieces.
+ */
+typedef struct {
+    size_t n;
+    size_t nan_count;
+    size_t pos_inf;
+    size_t neg_inf;
+    double mean;
+    double m2;
+    float min;
+    float max;
+} stats_acc;
+
+static const size_t STATS_BLOCK = 1024;  // Vector steps per lane before merging
+// -------------------------------------------------------------------------------- 
 
-    return sqrtf(sum_sq_diff / vec->len);
+static void _stats_init(stats_acc* acc) {
+    memset(acc, 0, sizeof(*acc));
+    acc->min = INFINITY;
+    acc->max = -INFINITY;
 }
-
 // -------------------------------------------------------------------------------- 
 
-float_v* cum_sum_float_vector(float_v* vec) {
-    if (!vec || !vec->data || vec->len == 0) {
-        errno = EINVAL;
-        return NULL;
+static void _stats_push(stats_acc* acc, float x) {
+    if (isnan(x)) {
+        acc->nan_count++;
+        return;
     }
-
-    float_v* new_vec = init_float_vector(vec->len);
-    if (!new_vec) {
-        errno = ENOMEM;
-        return NULL;
+    if (x < acc->min) acc->min = x;
+    if (x > acc->max) acc->max = x;
+    if (isinf(x)) {
+        if (x > 0) acc->pos_inf++;
+        else acc->neg_inf++;
+        return;
     }
+    acc->n++;
+    double delta = x - acc->mean;
+    acc->mean += delta / acc->n;
+    acc->m2 += delta * (x - acc->mean);
+}
+// -------------------------------------------------------------------------------- 
 
-    float sum = 0.0f;
-    for (size_t i = 0; i < vec->len; ++i) {
-        float val = vec->data[i];
-        if (isnan(val)) {
-            errno = EINVAL;
-            free_float_vector(new_vec);
-            return NULL;
-        }
+static void _stats_merge_moments(stats_acc* acc, size_t n, double mean, double m2) {
+    if (n == 0) return;
+    size_t total = acc->n + n;
+    double delta = mean - acc->mean;
+    acc->mean += delta * ((double)n / total);
+    acc->m2 += m2 + delta * delta * ((double)acc->n * n / total);
+    acc->n = total;
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Folds per-lane Welford states, each built from steps values, into acc
+ */
+static void _stats_merge_lanes(stats_acc* acc, const float* mean, const float* m2,
+                               size_t lanes, size_t steps) {
+    for (size_t j = 0; j < lanes; ++j)
+        _stats_merge_moments(acc, steps, mean[j], m2[j]);
+}
+// -------------------------------------------------------------------------------- 
 
-        sum += val;
+static void _describe_scalar(const float* data, size_t len, stats_acc* acc) {
+    for (size_t i = 0; i < len; ++i)
+        _stats_push(acc, data[i]);
+}
+// -------------------------------------------------------------------------------- 
 
-        if (isinf(sum)) {
-            // Fill rest with infinity
-            for (; i < vec->len; ++i) {
-                push_back_float_vector(new_vec, INFINITY);
+/**
+ * @brief Inclusive prefix scan of src into dst, seeded with carry
+ *
+ * Sums and products run in double precision and the running value is returned
+ * unrounded, so a long scan split into blocks carries no float drift between
+ * them.  cum_min and cum_max skip NaN values.  src and dst may alias.
+ */
+static double _scan_scalar(const float* src, float* dst, size_t len, scan_op op,
+                           double carry) {
+    switch (op) {
+        case SCAN_SUM:
+            for (size_t i = 0; i < len; ++i) {
+                carry += src[i];
+                dst[i] = (float)carry;
+            }
+            return carry;
+        case SCAN_PROD:
+            for (size_t i = 0; i < len; ++i) {
+                carry *= src[i];
+                dst[i] = (float)carry;
             }
-            return new_vec;
+            return carry;
+        case SCAN_MIN: {
+            float min_val = (float)carry;
+            for (size_t i = 0; i < len; ++i) {
+                if (src[i] < min_val) min_val = src[i];
+                dst[i] = min_val;
+            }
+            return min_val;
         }
-
-        if (!push_back_float_vector(new_vec, sum)) {
-            free_float_vector(new_vec);
-            return NULL;
+        case SCAN_MAX:
+        default: {
+            float max_val = (float)carry;
+            for (size_t i = 0; i < len; ++i) {
+                if (src[i] > max_val) max_val = src[i];
+                dst[i] = max_val;
+            }
+            return max_val;
         }
     }
+}
+// -------------------------------------------------------------------------------- 
 
-    return new_vec;
+#if defined(C_FLOAT_X86)
+
+SIMD_TARGET("sse2") static inline float _hmin_sse2(__m128 v) {
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, 0x1));
+    return _mm_cvtss_f32(v);
 }
 // -------------------------------------------------------------------------------- 
 
-float_v* copy_float_vector(const float_v* original) {
-    if (!original) {
-        errno = EINVAL;
-        return NULL;
-    }
+SIMD_TARGET("sse2") static inline float _hmax_sse2(__m128 v) {
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, 0x1));
+    return _mm_cvtss_f32(v);
+}
+// -------------------------------------------------------------------------------- 
 
-    float_v* copy = init_float_vector(original->alloc);
-    if (!copy) {
-        return NULL;
-    }
+SIMD_TARGET("sse2") static inline float _hsum_sse2(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 0x1));
+    return _mm_cvtss_f32(v);
+}
+// -------------------------------------------------------------------------------- 
 
-    for (size_t i = 0; i < original->len; ++i) {
-        if (!push_back_float_vector(copy, original->data[i])) {
-            free_float_vector(copy);
-            return NULL;
-        }
-    }
+// min_ps and max_ps return their second operand when either is NaN, so the
+// accumulator goes second and NaN inputs are skipped as _min_scalar skips them
+SIMD_TARGET("sse2") static float _min_sse2(const float* data, size_t len) {
+    __m128 vmin = _mm_set1_ps(FLT_MAX);
+    size_t i = 0;
 
-    return copy;
+    for (; i + 3 < len; i += 4)
+        vmin = _mm_min_ps(_mm_loadu_ps(&data[i]), vmin);
+
+    float min_val = _hmin_sse2(vmin);
+    for (; i < len; ++i)
+        if (data[i] < min_val)
+            min_val = data[i];
+    return min_val;
 }
-// ================================================================================
-// ================================================================================
-// DICTIONARY IMPLEMENTATION
+// -------------------------------------------------------------------------------- 
 
-typedef struct fdictNode {
-    char* key;
-    float value;
-    struct fdictNode* next;
-} fdictNode;
-// --------------------------------------------------------------------------------
+SIMD_TARGET("sse2") static float _max_sse2(const float* data, size_t len) {
+    __m128 vmax = _mm_set1_ps(-FLT_MAX);
+    size_t i = 0;
 
-struct dict_f {
-    fdictNode* keyValues;
-    size_t hash_size;
-    size_t len;
-    size_t alloc;
-};
-// --------------------------------------------------------------------------------
+    for (; i + 3 < len; i += 4)
+        vmax = _mm_max_ps(_mm_loadu_ps(&data[i]), vmax);
+
+    float max_val = _hmax_sse2(vmax);
+    for (; i < len; ++i)
+        if (data[i] > max_val)
+            max_val = data[i];
+    return max_val;
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("sse2") static float _sum_sse2(const float* data, size_t len) {
+    __m128 vsum = _mm_setzero_ps();
+    size_t i = 0;
+
+    for (; i + 3 < len; i += 4)
+        vsum = _mm_add_ps(vsum, _mm_loadu_ps(&data[i]));
+
+    float sum = _hsum_sse2(vsum);
+    for (; i < len; ++i)
+        sum += data[i];
+    return sum;
+}
+// -------------------------------------------------------------------------------- 
 
 /**
- * @brief MurmurHash3-inspired hash function for strings
- * 
- * @param key The string key to hash
- * @param seed Optional seed for hash randomization (helps prevent hash flooding)
- * @return size_t The computed hash value
+ * @brief Folds the lane sums and lane compensations of a Kahan kernel together
+ *        with a scalar tail
  */
-static size_t hash_function(const char* key, const uint32_t seed) {
-    if (!key) {
-        return 0;
-    }
+static float _kahan_finish(const float* sums, const float* comps, size_t lanes,
+                           const float* tail, size_t tail_len) {
+    double total = 0.0;
+    for (size_t j = 0; j < lanes; ++j)
+        total += (double)sums[j] + (double)comps[j];
+    for (size_t i = 0; i < tail_len; ++i)
+        total += tail[i];
+    return (float)total;
+}
+// -------------------------------------------------------------------------------- 
 
-    // Constants for mixing
-    const uint32_t c1 = 0xcc9e2d51;
-    const uint32_t c2 = 0x1b873593;
-    uint32_t h1 = seed;
+SIMD_TARGET("sse2") static float _sum_kahan_sse2(const float* data, size_t len) {
+    const __m128 vabs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 vinf = _mm_set1_ps(INFINITY);
+    __m128 vsum = _mm_setzero_ps();
+    __m128 vcomp = _mm_setzero_ps();
+    float sums[4], comps[4];
+    size_t i = 0;
 
-    // Process key in 4-byte chunks
-    const unsigned char* data = (const unsigned char*)key;
-    size_t len = strlen(key);
-    const size_t nblocks = len / 4;
+    for (; i + 3 < len; i += 4) {
+        __m128 x = _mm_loadu_ps(&data[i]);
+        __m128 t = _mm_add_ps(vsum, x);
+        __m128 big_sum = _mm_cmpge_ps(_mm_and_ps(vsum, vabs), _mm_and_ps(x, vabs));
+        __m128 if_sum = _mm_add_ps(_mm_sub_ps(vsum, t), x);
+        __m128 if_x = _mm_add_ps(_mm_sub_ps(x, t), vsum);
+        __m128 finite = _mm_cmplt_ps(_mm_and_ps(t, vabs), vinf);
+        __m128 delta = _mm_or_ps(_mm_and_ps(big_sum, if_sum), _mm_andnot_ps(big_sum, if_x));
+        vcomp = _mm_add_ps(vcomp, _mm_and_ps(finite, delta));
+        vsum = t;
+    }
+    _mm_storeu_ps(sums, vsum);
+    _mm_storeu_ps(comps, vcomp);
+    return _kahan_finish(sums, comps, 4, &data[i], len - i);
+}
+// -------------------------------------------------------------------------------- 
 
-    // Body
-    const uint32_t* blocks = (const uint32_t*)(data);
-    for (size_t i = 0; i < nblocks; i++) {
-        uint32_t k1 = blocks[i];
+SIMD_TARGET("sse2") static float _sum_double_sse2(const float* data, size_t len) {
+    __m128d lo = _mm_setzero_pd();
+    __m128d hi = _mm_setzero_pd();
+    size_t i = 0;
 
-        k1 *= c1;
-        k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
-        k1 *= c2;
+    for (; i + 3 < len; i += 4) {
+        __m128 v = _mm_loadu_ps(&data[i]);
+        lo = _mm_add_pd(lo, _mm_cvtps_pd(v));
+        hi = _mm_add_pd(hi, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    lo = _mm_add_pd(lo, hi);
+    double sum = _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    for (; i < len; ++i)
+        sum += data[i];
+    return (float)sum;
+}
+// -------------------------------------------------------------------------------- 
 
-        h1 ^= k1;
-        h1 = (h1 << 13) | (h1 >> 19);  // ROTL32(h1, 13)
-        h1 = h1 * 5 + 0xe6546b64;
+SIMD_TARGET("sse2") static float _sum_sq_diff_sse2(const float* data, size_t len, float mean) {
+    const __m128 vmean = _mm_set1_ps(mean);
+    const __m128 vabs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 vinf = _mm_set1_ps(INFINITY);
+    __m128 vsum = _mm_setzero_ps();
+    __m128 vnonfinite = _mm_setzero_ps();
+    size_t i = 0;
+
+    // Infinities are accumulated into a lane mask rather than tested per element
+    for (; i + 3 < len; i += 4) {
+        __m128 v = _mm_loadu_ps(&data[i]);
+        __m128 diff = _mm_sub_ps(v, vmean);
+        vnonfinite = _mm_or_ps(vnonfinite, _mm_cmpeq_ps(_mm_and_ps(v, vabs), vinf));
+        vsum = _mm_add_ps(vsum, _mm_mul_ps(diff, diff));
+    }
+    if (_mm_movemask_ps(vnonfinite)) return INFINITY;
+
+    float sum_sq_diff = _hsum_sse2(vsum);
+    for (; i < len; ++i) {
+        if (isinf(data[i])) return INFINITY;
+        float diff = data[i] - mean;
+        sum_sq_diff += diff * diff;
     }
+    return sum_sq_diff;
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static float _min_avx2(const float* data, size_t len) {
+    __m256 vmin = _mm256_set1_ps(FLT_MAX);
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8)
+        vmin = _mm256_min_ps(_mm256_loadu_ps(&data[i]), vmin);
+
+    float min_val = _hmin_sse2(_mm_min_ps(_mm256_castps256_ps128(vmin),
+                                          _mm256_extractf128_ps(vmin, 1)));
+    for (; i < len; ++i)
+        if (data[i] < min_val)
+            min_val = data[i];
+    return min_val;
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static float _max_avx2(const float* data, size_t len) {
+    __m256 vmax = _mm256_set1_ps(-FLT_MAX);
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8)
+        vmax = _mm256_max_ps(_mm256_loadu_ps(&data[i]), vmax);
+
+    float max_val = _hmax_sse2(_mm_max_ps(_mm256_castps256_ps128(vmax),
+                                          _mm256_extractf128_ps(vmax, 1)));
+    for (; i < len; ++i)
+        if (data[i] > max_val)
+            max_val = data[i];
+    return max_val;
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static float _sum_avx2(const float* data, size_t len) {
+    __m256 vsum = _mm256_setzero_ps();
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8)
+        vsum = _mm256_add_ps(vsum, _mm256_loadu_ps(&data[i]));
+
+    float sum = _hsum_sse2(_mm_add_ps(_mm256_castps256_ps128(vsum),
+                                      _mm256_extractf128_ps(vsum, 1)));
+    for (; i < len; ++i)
+        sum += data[i];
+    return sum;
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static float _sum_kahan_avx2(const float* data, size_t len) {
+    const __m256 vabs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 vinf = _mm256_set1_ps(INFINITY);
+    __m256 vsum = _mm256_setzero_ps();
+    __m256 vcomp = _mm256_setzero_ps();
+    float sums[8], comps[8];
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8) {
+        __m256 x = _mm256_loadu_ps(&data[i]);
+        __m256 t = _mm256_add_ps(vsum, x);
+        __m256 big_sum = _mm256_cmp_ps(_mm256_and_ps(vsum, vabs), _mm256_and_ps(x, vabs),
+                                       _CMP_GE_OQ);
+        __m256 if_sum = _mm256_add_ps(_mm256_sub_ps(vsum, t), x);
+        __m256 if_x = _mm256_add_ps(_mm256_sub_ps(x, t), vsum);
+        __m256 finite = _mm256_cmp_ps(_mm256_and_ps(t, vabs), vinf, _CMP_LT_OQ);
+        __m256 delta = _mm256_blendv_ps(if_x, if_sum, big_sum);
+        vcomp = _mm256_add_ps(vcomp, _mm256_and_ps(finite, delta));
+        vsum = t;
+    }
+    _mm256_storeu_ps(sums, vsum);
+    _mm256_storeu_ps(comps, vcomp);
+    return _kahan_finish(sums, comps, 8, &data[i], len - i);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static float _sum_double_avx2(const float* data, size_t len) {
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8) {
+        lo = _mm256_add_pd(lo, _mm256_cvtps_pd(_mm_loadu_ps(&data[i])));
+        hi = _mm256_add_pd(hi, _mm256_cvtps_pd(_mm_loadu_ps(&data[i + 4])));
+    }
+    lo = _mm256_add_pd(lo, hi);
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(lo), _mm256_extractf128_pd(lo, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; i < len; ++i)
+        sum += data[i];
+    return (float)sum;
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static float _sum_sq_diff_avx2(const float* data, size_t len, float mean) {
+    const __m256 vmean = _mm256_set1_ps(mean);
+    const __m256 vabs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 vinf = _mm256_set1_ps(INFINITY);
+    __m256 vsum = _mm256_setzero_ps();
+    __m256 vnonfinite = _mm256_setzero_ps();
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8) {
+        __m256 v = _mm256_loadu_ps(&data[i]);
+        __m256 diff = _mm256_sub_ps(v, vmean);
+        vnonfinite = _mm256_or_ps(vnonfinite,
+                                  _mm256_cmp_ps(_mm256_and_ps(v, vabs), vinf, _CMP_EQ_OQ));
+        vsum = _mm256_add_ps(vsum, _mm256_mul_ps(diff, diff));
+    }
+    if (_mm256_movemask_ps(vnonfinite)) return INFINITY;
+
+    float sum_sq_diff = _hsum_sse2(_mm_add_ps(_mm256_castps256_ps128(vsum),
+                                              _mm256_extractf128_ps(vsum, 1)));
+    for (; i < len; ++i) {
+        if (isinf(data[i])) return INFINITY;
+        float diff = data[i] - mean;
+        sum_sq_diff += diff * diff;
+    }
+    return sum_sq_diff;
+}
+// -------------------------------------------------------------------------------- 
+
+// AVX-512 kernels finish the buffer with a masked load instead of a scalar tail
+SIMD_TARGET("avx512f") static inline __mmask16 _tail_mask16(size_t remaining) {
+    return (__mmask16)((1u << remaining) - 1u);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static float _min_avx512(const float* data, size_t len) {
+    __m512 vmin = _mm512_set1_ps(FLT_MAX);
+    size_t i = 0;
+
+    for (; i + 15 < len; i += 16)
+        vmin = _mm512_min_ps(_mm512_loadu_ps(&data[i]), vmin);
+    if (i < len)
+        vmin = _mm512_min_ps(_mm512_mask_loadu_ps(_mm512_set1_ps(FLT_MAX),
+                                                  _tail_mask16(len - i), &data[i]), vmin);
+    return _mm512_reduce_min_ps(vmin);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static float _max_avx512(const float* data, size_t len) {
+    __m512 vmax = _mm512_set1_ps(-FLT_MAX);
+    size_t i = 0;
+
+    for (; i + 15 < len; i += 16)
+        vmax = _mm512_max_ps(_mm512_loadu_ps(&data[i]), vmax);
+    if (i < len)
+        vmax = _mm512_max_ps(_mm512_mask_loadu_ps(_mm512_set1_ps(-FLT_MAX),
+                                                  _tail_mask16(len - i), &data[i]), vmax);
+    return _mm512_reduce_max_ps(vmax);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static float _sum_avx512(const float* data, size_t len) {
+    __m512 vsum = _mm512_setzero_ps();
+    size_t i = 0;
+
+    for (; i + 15 < len; i += 16)
+        vsum = _mm512_add_ps(vsum, _mm512_loadu_ps(&data[i]));
+    if (i < len)
+        vsum = _mm512_add_ps(vsum, _mm512_maskz_loadu_ps(_tail_mask16(len - i), &data[i]));
+    return _mm512_reduce_add_ps(vsum);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static float _sum_kahan_avx512(const float* data, size_t len) {
+    __m512 vsum = _mm512_setzero_ps();
+    __m512 vcomp = _mm512_setzero_ps();
+    float sums[16], comps[16];
+    size_t i = 0;
+
+    for (; i + 15 < len; i += 16) {
+        __m512 x = _mm512_loadu_ps(&data[i]);
+        __m512 t = _mm512_add_ps(vsum, x);
+        __mmask16 big_sum = _mm512_cmp_ps_mask(_mm512_abs_ps(vsum), _mm512_abs_ps(x), _CMP_GE_OQ);
+        __m512 if_sum = _mm512_add_ps(_mm512_sub_ps(vsum, t), x);
+        __m512 if_x = _mm512_add_ps(_mm512_sub_ps(x, t), vsum);
+        __mmask16 finite = _mm512_cmp_ps_mask(_mm512_abs_ps(t), _mm512_set1_ps(INFINITY),
+                                              _CMP_LT_OQ);
+        vcomp = _mm512_mask_add_ps(vcomp, finite, vcomp,
+                                   _mm512_mask_blend_ps(big_sum, if_x, if_sum));
+        vsum = t;
+    }
+    _mm512_storeu_ps(sums, vsum);
+    _mm512_storeu_ps(comps, vcomp);
+    return _kahan_finish(sums, comps, 16, &data[i], len - i);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static float _sum_double_avx512(const float* data, size_t len) {
+    __m512d lo = _mm512_setzero_pd();
+    __m512d hi = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for (; i + 15 < len; i += 16) {
+        lo = _mm512_add_pd(lo, _mm512_cvtps_pd(_mm256_loadu_ps(&data[i])));
+        hi = _mm512_add_pd(hi, _mm512_cvtps_pd(_mm256_loadu_ps(&data[i + 8])));
+    }
+    if (i < len) {
+        __mmask16 mask = _tail_mask16(len - i);
+        __m512 v = _mm512_maskz_loadu_ps(mask, &data[i]);
+        lo = _mm512_add_pd(lo, _mm512_cvtps_pd(_mm512_castps512_ps256(v)));
+        hi = _mm512_add_pd(hi, _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1))));
+    }
+    return (float)_mm512_reduce_add_pd(_mm512_add_pd(lo, hi));
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static float _sum_sq_diff_avx512(const float* data, size_t len, float mean) {
+    const __m512 vmean = _mm512_set1_ps(mean);
+    const __m512 vinf = _mm512_set1_ps(INFINITY);
+    __m512 vsum = _mm512_setzero_ps();
+    __mmask16 nonfinite = 0;
+    size_t i = 0;
+
+    for (; i + 15 < len; i += 16) {
+        __m512 v = _mm512_loadu_ps(&data[i]);
+        __m512 diff = _mm512_sub_ps(v, vmean);
+        nonfinite |= _mm512_cmp_ps_mask(_mm512_abs_ps(v), vinf, _CMP_EQ_OQ);
+        vsum = _mm512_add_ps(vsum, _mm512_mul_ps(diff, diff));
+    }
+    if (i < len) {
+        __mmask16 mask = _tail_mask16(len - i);
+        __m512 v = _mm512_maskz_loadu_ps(mask, &data[i]);
+        __m512 diff = _mm512_maskz_sub_ps(mask, v, vmean);
+        nonfinite |= _mm512_cmp_ps_mask(_mm512_abs_ps(v), vinf, _CMP_EQ_OQ);
+        vsum = _mm512_add_ps(vsum, _mm512_mul_ps(diff, diff));
+    }
+    if (nonfinite) return INFINITY;
+    return _mm512_reduce_add_ps(vsum);
+}
+// -------------------------------------------------------------------------------- 
+
+// The describe kernels run a Welford update in every lane.  While a block only
+// holds finite values all lanes share the same count, so the reciprocal is a
+// broadcast scalar.  A vector containing NaN or Inf is routed through the
+// scalar accumulator instead, which keeps the lane counts in step.
+SIMD_TARGET("sse2") static void _describe_sse2(const float* data, size_t len, stats_acc* acc) {
+    const __m128 vabs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 vinf = _mm_set1_ps(INFINITY);
+    __m128 vmin = _mm_set1_ps(INFINITY);
+    __m128 vmax = _mm_set1_ps(-INFINITY);
+    float lane_mean[4], lane_m2[4];
+    size_t i = 0;
+
+    while (i + 3 < len) {
+        __m128 mean = _mm_setzero_ps();
+        __m128 m2 = _mm_setzero_ps();
+        size_t steps = 0;
+        for (; i + 3 < len && steps < STATS_BLOCK; i += 4) {
+            __m128 v = _mm_loadu_ps(&data[i]);
+            if (_mm_movemask_ps(_mm_cmplt_ps(_mm_and_ps(v, vabs), vinf)) != 0xf) {
+                for (size_t j = 0; j < 4; ++j) _stats_push(acc, data[i + j]);
+                continue;
+            }
+            steps++;
+            __m128 inv = _mm_set1_ps(1.0f / (float)steps);
+            __m128 delta = _mm_sub_ps(v, mean);
+            mean = _mm_add_ps(mean, _mm_mul_ps(delta, inv));
+            m2 = _mm_add_ps(m2, _mm_mul_ps(delta, _mm_sub_ps(v, mean)));
+            vmin = _mm_min_ps(vmin, v);
+            vmax = _mm_max_ps(vmax, v);
+        }
+        if (steps) {
+            _mm_storeu_ps(lane_mean, mean);
+            _mm_storeu_ps(lane_m2, m2);
+            _stats_merge_lanes(acc, lane_mean, lane_m2, 4, steps);
+        }
+    }
+
+    float min_val = _hmin_sse2(vmin);
+    float max_val = _hmax_sse2(vmax);
+    if (min_val < acc->min) acc->min = min_val;
+    if (max_val > acc->max) acc->max = max_val;
+    for (; i < len; ++i)
+        _stats_push(acc, data[i]);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static void _describe_avx2(const float* data, size_t len, stats_acc* acc) {
+    const __m256 vabs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 vinf = _mm256_set1_ps(INFINITY);
+    __m256 vmin = _mm256_set1_ps(INFINITY);
+    __m256 vmax = _mm256_set1_ps(-INFINITY);
+    float lane_mean[8], lane_m2[8];
+    size_t i = 0;
+
+    while (i + 7 < len) {
+        __m256 mean = _mm256_setzero_ps();
+        __m256 m2 = _mm256_setzero_ps();
+        size_t steps = 0;
+        for (; i + 7 < len && steps < STATS_BLOCK; i += 8) {
+            __m256 v = _mm256_loadu_ps(&data[i]);
+            __m256 finite = _mm256_cmp_ps(_mm256_and_ps(v, vabs), vinf, _CMP_LT_OQ);
+            if (_mm256_movemask_ps(finite) != 0xff) {
+                for (size_t j = 0; j < 8; ++j) _stats_push(acc, data[i + j]);
+                continue;
+            }
+            steps++;
+            __m256 inv = _mm256_set1_ps(1.0f / (float)steps);
+            __m256 delta = _mm256_sub_ps(v, mean);
+            mean = _mm256_add_ps(mean, _mm256_mul_ps(delta, inv));
+            m2 = _mm256_add_ps(m2, _mm256_mul_ps(delta, _mm256_sub_ps(v, mean)));
+            vmin = _mm256_min_ps(vmin, v);
+            vmax = _mm256_max_ps(vmax, v);
+        }
+        if (steps) {
+            _mm256_storeu_ps(lane_mean, mean);
+            _mm256_storeu_ps(lane_m2, m2);
+            _stats_merge_lanes(acc, lane_mean, lane_m2, 8, steps);
+        }
+    }
+
+    float min_val = _hmin_sse2(_mm_min_ps(_mm256_castps256_ps128(vmin),
+                                          _mm256_extractf128_ps(vmin, 1)));
+    float max_val = _hmax_sse2(_mm_max_ps(_mm256_castps256_ps128(vmax),
+                                          _mm256_extractf128_ps(vmax, 1)));
+    if (min_val < acc->min) acc->min = min_val;
+    if (max_val > acc->max) acc->max = max_val;
+    for (; i < len; ++i)
+        _stats_push(acc, data[i]);
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static void _describe_avx512(const float* data, size_t len, stats_acc* acc) {
+    const __m512 vinf = _mm512_set1_ps(INFINITY);
+    __m512 vmin = _mm512_set1_ps(INFINITY);
+    __m512 vmax = _mm512_set1_ps(-INFINITY);
+    float lane_mean[16], lane_m2[16];
+    size_t i = 0;
+
+    while (i + 15 < len) {
+        __m512 mean = _mm512_setzero_ps();
+        __m512 m2 = _mm512_setzero_ps();
+        size_t steps = 0;
+        for (; i + 15 < len && steps < STATS_BLOCK; i += 16) {
+            __m512 v = _mm512_loadu_ps(&data[i]);
+            if (_mm512_cmp_ps_mask(_mm512_abs_ps(v), vinf, _CMP_LT_OQ) != 0xffff) {
+                for (size_t j = 0; j < 16; ++j) _stats_push(acc, data[i + j]);
+                continue;
+            }
+            steps++;
+            __m512 inv = _mm512_set1_ps(1.0f / (float)steps);
+            __m512 delta = _mm512_sub_ps(v, mean);
+            mean = _mm512_add_ps(mean, _mm512_mul_ps(delta, inv));
+            m2 = _mm512_add_ps(m2, _mm512_mul_ps(delta, _mm512_sub_ps(v, mean)));
+            vmin = _mm512_min_ps(vmin, v);
+            vmax = _mm512_max_ps(vmax, v);
+        }
+        if (steps) {
+            _mm512_storeu_ps(lane_mean, mean);
+            _mm512_storeu_ps(lane_m2, m2);
+            _stats_merge_lanes(acc, lane_mean, lane_m2, 16, steps);
+        }
+    }
+
+    float min_val = _mm512_reduce_min_ps(vmin);
+    float max_val = _mm512_reduce_max_ps(vmax);
+    if (min_val < acc->min) acc->min = min_val;
+    if (max_val > acc->max) acc->max = max_val;
+    for (; i < len; ++i)
+        _stats_push(acc, data[i]);
+}
+// -------------------------------------------------------------------------------- 
+
+// Prefix scans work on one register at a time: log2(lanes) shift-and-combine
+// steps build the in-register prefix, then the carry from the previous
+// register is folded in and the last lane becomes the next carry.  Sums and
+// products are widened to double lanes; min and max stay in float and use
+// shifts that repeat lane 0, which is harmless because min and max are
+// idempotent.  NaN lanes are replaced by the identity so they are skipped.
+
+SIMD_TARGET("sse2") static double _scan_arith_sse2(const float* src, float* dst, size_t len,
+                                                   double carry, bool prod) {
+    const __m128d ident = _mm_set1_pd(prod ? 1.0 : 0.0);
+    __m128d c = _mm_set1_pd(carry);
+    size_t i = 0;
+
+    for (; i + 3 < len; i += 4) {
+        __m128 v = _mm_loadu_ps(&src[i]);
+        __m128d lo = _mm_cvtps_pd(v);
+        __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        if (prod) {
+            lo = _mm_mul_pd(_mm_mul_pd(lo, _mm_unpacklo_pd(ident, lo)), c);
+            hi = _mm_mul_pd(hi, _mm_unpacklo_pd(ident, hi));
+            hi = _mm_mul_pd(hi, _mm_unpackhi_pd(lo, lo));
+        } else {
+            lo = _mm_add_pd(_mm_add_pd(lo, _mm_unpacklo_pd(ident, lo)), c);
+            hi = _mm_add_pd(hi, _mm_unpacklo_pd(ident, hi));
+            hi = _mm_add_pd(hi, _mm_unpackhi_pd(lo, lo));
+        }
+        c = _mm_unpackhi_pd(hi, hi);
+        _mm_storeu_ps(&dst[i], _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+    }
+
+    return _scan_scalar(src + i, dst + i, len - i, prod ? SCAN_PROD : SCAN_SUM,
+                        _mm_cvtsd_f64(c));
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("sse2") static double _scan_extreme_sse2(const float* src, float* dst, size_t len,
+                                                     float carry, bool max) {
+    const __m128 ident = _mm_set1_ps(max ? -INFINITY : INFINITY);
+    __m128 c = _mm_set1_ps(carry);
+    size_t i = 0;
+
+    for (; i + 3 < len; i += 4) {
+        __m128 x = _mm_loadu_ps(&src[i]);
+        __m128 nan = _mm_cmpunord_ps(x, x);
+        x = _mm_or_ps(_mm_and_ps(nan, ident), _mm_andnot_ps(nan, x));
+        __m128 s1 = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 1, 0, 0));
+        x = max ? _mm_max_ps(x, s1) : _mm_min_ps(x, s1);
+        __m128 s2 = _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 0, 0));
+        x = max ? _mm_max_ps(x, s2) : _mm_min_ps(x, s2);
+        x = max ? _mm_max_ps(x, c) : _mm_min_ps(x, c);
+        c = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm_storeu_ps(&dst[i], x);
+    }
+
+    return _scan_scalar(src + i, dst + i, len - i, max ? SCAN_MAX : SCAN_MIN,
+                        _mm_cvtss_f32(c));
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static double _scan_arith_avx2(const float* src, float* dst, size_t len,
+                                                   double carry, bool prod) {
+    const __m256d ident = _mm256_set1_pd(prod ? 1.0 : 0.0);
+    __m256d c = _mm256_set1_pd(carry);
+    size_t i = 0;
+
+    for (; i + 3 < len; i += 4) {
+        __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(&src[i]));
+        __m256d s1 = _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(2, 1, 0, 0)), ident, 0x1);
+        x = prod ? _mm256_mul_pd(x, s1) : _mm256_add_pd(x, s1);
+        __m256d s2 = _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(1, 0, 0, 0)), ident, 0x3);
+        x = prod ? _mm256_mul_pd(x, s2) : _mm256_add_pd(x, s2);
+        x = prod ? _mm256_mul_pd(x, c) : _mm256_add_pd(x, c);
+        c = _mm256_permute4x64_pd(x, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm_storeu_ps(&dst[i], _mm256_cvtpd_ps(x));
+    }
+
+    return _scan_scalar(src + i, dst + i, len - i, prod ? SCAN_PROD : SCAN_SUM,
+                        _mm256_cvtsd_f64(c));
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx2") static double _scan_extreme_avx2(const float* src, float* dst, size_t len,
+                                                     float carry, bool max) {
+    const __m256 ident = _mm256_set1_ps(max ? -INFINITY : INFINITY);
+    const __m256i shift1 = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+    const __m256i shift2 = _mm256_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5);
+    const __m256i shift4 = _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 2, 3);
+    const __m256i last = _mm256_set1_epi32(7);
+    __m256 c = _mm256_set1_ps(carry);
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8) {
+        __m256 x = _mm256_loadu_ps(&src[i]);
+        x = _mm256_blendv_ps(x, ident, _mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+        __m256 s1 = _mm256_permutevar8x32_ps(x, shift1);
+        x = max ? _mm256_max_ps(x, s1) : _mm256_min_ps(x, s1);
+        __m256 s2 = _mm256_permutevar8x32_ps(x, shift2);
+        x = max ? _mm256_max_ps(x, s2) : _mm256_min_ps(x, s2);
+        __m256 s4 = _mm256_permutevar8x32_ps(x, shift4);
+        x = max ? _mm256_max_ps(x, s4) : _mm256_min_ps(x, s4);
+        x = max ? _mm256_max_ps(x, c) : _mm256_min_ps(x, c);
+        c = _mm256_permutevar8x32_ps(x, last);
+        _mm256_storeu_ps(&dst[i], x);
+    }
+
+    return _scan_scalar(src + i, dst + i, len - i, max ? SCAN_MAX : SCAN_MIN,
+                        _mm256_cvtss_f32(c));
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static double _scan_arith_avx512(const float* src, float* dst, size_t len,
+                                                        double carry, bool prod) {
+    const __m512d ident = _mm512_set1_pd(prod ? 1.0 : 0.0);
+    const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+    const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+    const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+    const __m512i last = _mm512_set1_epi64(7);
+    __m512d c = _mm512_set1_pd(carry);
+    size_t i = 0;
+
+    for (; i + 7 < len; i += 8) {
+        __m512d x = _mm512_cvtps_pd(_mm256_loadu_ps(&src[i]));
+        __m512d s1 = _mm512_mask_permutexvar_pd(ident, 0xFE, shift1, x);
+        x = prod ? _mm512_mul_pd(x, s1) : _mm512_add_pd(x, s1);
+        __m512d s2 = _mm512_mask_permutexvar_pd(ident, 0xFC, shift2, x);
+        x = prod ? _mm512_mul_pd(x, s2) : _mm512_add_pd(x, s2);
+        __m512d s4 = _mm512_mask_permutexvar_pd(ident, 0xF0, shift4, x);
+        x = prod ? _mm512_mul_pd(x, s4) : _mm512_add_pd(x, s4);
+        x = prod ? _mm512_mul_pd(x, c) : _mm512_add_pd(x, c);
+        c = _mm512_permutexvar_pd(last, x);
+        _mm256_storeu_ps(&dst[i], _mm512_cvtpd_ps(x));
+    }
+
+    return _scan_scalar(src + i, dst + i, len - i, prod ? SCAN_PROD : SCAN_SUM,
+                        _mm512_cvtsd_f64(c));
+}
+// -------------------------------------------------------------------------------- 
+
+SIMD_TARGET("avx512f") static double _scan_extreme_avx512(const float* src, float* dst, size_t len,
+                                                          float carry, bool max) {
+    const __m512 ident = _mm512_set1_ps(max ? -INFINITY : INFINITY);
+    const __m512i shift1 = _mm512_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14);
+    const __m512i shift2 = _mm512_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13);
+    const __m512i shift4 = _mm512_setr_epi32(0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11);
+    const __m512i shift8 = _mm512_setr_epi32(0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512i last = _mm512_set1_epi32(15);
+    __m512 c = _mm512_set1_ps(carry);
+    size_t i = 0;
+
+    for (; i + 15 < len; i += 16) {
+        __m512 x = _mm512_loadu_ps(&src[i]);
+        x = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q), x, ident);
+        __m512 s1 = _mm512_permutexvar_ps(shift1, x);
+        x = max ? _mm512_max_ps(x, s1) : _mm512_min_ps(x, s1);
+        __m512 s2 = _mm512_permutexvar_ps(shift2, x);
+        x = max ? _mm512_max_ps(x, s2) : _mm512_min_ps(x, s2);
+        __m512 s4 = _mm512_permutexvar_ps(shift4, x);
+        x = max ? _mm512_max_ps(x, s4) : _mm512_min_ps(x, s4);
+        __m512 s8 = _mm512_permutexvar_ps(shift8, x);
+        x = max ? _mm512_max_ps(x, s8) : _mm512_min_ps(x, s8);
+        x = max ? _mm512_max_ps(x, c) : _mm512_min_ps(x, c);
+        c = _mm512_permutexvar_ps(last, x);
+        _mm512_storeu_ps(&dst[i], x);
+    }
+
+    return _scan_scalar(src + i, dst + i, len - i, max ? SCAN_MAX : SCAN_MIN,
+                        _mm512_cvtss_f32(c));
+}
+// -------------------------------------------------------------------------------- 
+
+static double _scan_sse2(const float* src, float* dst, size_t len, scan_op op, double carry) {
+    switch (op) {
+        case SCAN_SUM:  return _scan_arith_sse2(src, dst, len, carry, false);
+        case SCAN_PROD: return _scan_arith_sse2(src, dst, len, carry, true);
+        case SCAN_MIN:  return _scan_extreme_sse2(src, dst, len, (float)carry, false);
+        case SCAN_MAX:
+        default:        return _scan_extreme_sse2(src, dst, len, (float)carry, true);
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+static double _scan_avx2(const float* src, float* dst, size_t len, scan_op op, double carry) {
+    switch (op) {
+        case SCAN_SUM:  return _scan_arith_avx2(src, dst, len, carry, false);
+        case SCAN_PROD: return _scan_arith_avx2(src, dst, len, carry, true);
+        case SCAN_MIN:  return _scan_extreme_avx2(src, dst, len, (float)carry, false);
+        case SCAN_MAX:
+        default:        return _scan_extreme_avx2(src, dst, len, (float)carry, true);
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+static double _scan_avx512(const float* src, float* dst, size_t len, scan_op op, double carry) {
+    switch (op) {
+        case SCAN_SUM:  return _scan_arith_avx512(src, dst, len, carry, false);
+        case SCAN_PROD: return _scan_arith_avx512(src, dst, len, carry, true);
+        case SCAN_MIN:  return _scan_extreme_avx512(src, dst, len, (float)carry, false);
+        case SCAN_MAX:
+        default:        return _scan_extreme_avx512(src, dst, len, (float)carry, true);
+    }
+}
+#endif /* C_FLOAT_X86 */
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Function table binding each reduction to one instruction set
+ */
+typedef struct {
+    simd_level level;
+    float (*min)(const float* data, size_t len);
+    float (*max)(const float* data, size_t len);
+    float (*sum)(const float* data, size_t len);
+    float (*sum_kahan)(const float* data, size_t len);
+    float (*sum_double)(const float* data, size_t len);
+    float (*sum_sq_diff)(const float* data, size_t len, float mean);
+    void (*describe)(const float* data, size_t len, stats_acc* acc);
+    double (*scan)(const float* src, float* dst, size_t len, scan_op op, double carry);
+} simd_kernels;
+
+static const simd_kernels SCALAR_KERNELS = {
+    .level = SIMD_SCALAR,
+    .min = _min_scalar,
+    .max = _max_scalar,
+    .sum = _sum_scalar,
+    .sum_kahan = _sum_kahan_scalar,
+    .sum_double = _sum_double_scalar,
+    .sum_sq_diff = _sum_sq_diff_scalar,
+    .describe = _describe_scalar,
+    .scan = _scan_scalar
+};
+#if defined(C_FLOAT_X86)
+static const simd_kernels SSE2_KERNELS = {
+    .level = SIMD_SSE2,
+    .min = _min_sse2,
+    .max = _max_sse2,
+    .sum = _sum_sse2,
+    .sum_kahan = _sum_kahan_sse2,
+    .sum_double = _sum_double_sse2,
+    .sum_sq_diff = _sum_sq_diff_sse2,
+    .describe = _describe_sse2,
+    .scan = _scan_sse2
+};
+static const simd_kernels AVX2_KERNELS = {
+    .level = SIMD_AVX2,
+    .min = _min_avx2,
+    .max = _max_avx2,
+    .sum = _sum_avx2,
+    .sum_kahan = _sum_kahan_avx2,
+    .sum_double = _sum_double_avx2,
+    .sum_sq_diff = _sum_sq_diff_avx2,
+    .describe = _describe_avx2,
+    .scan = _scan_avx2
+};
+static const simd_kernels AVX512_KERNELS = {
+    .level = SIMD_AVX512,
+    .min = _min_avx512,
+    .max = _max_avx512,
+    .sum = _sum_avx512,
+    .sum_kahan = _sum_kahan_avx512,
+    .sum_double = _sum_double_avx512,
+    .sum_sq_diff = _sum_sq_diff_avx512,
+    .describe = _describe_avx512,
+    .scan = _scan_avx512
+};
+#endif
+
+static const simd_kernels* active_kernels = NULL;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Returns the widest instruction set supported by the host CPU
+ *
+ * With GCC or Clang the CPU is probed through cpuid, which also verifies that
+ * the operating system saves the wider register state.  Other compilers fall
+ * back to the instruction sets enabled at compile time.
+ */
+static simd_level _cpu_simd_level(void) {
+#if defined(C_FLOAT_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+    return SIMD_SCALAR;
+#elif defined(C_FLOAT_X86)
+    #if defined(__AVX512F__)
+        return SIMD_AVX512;
+    #elif defined(__AVX2__)
+        return SIMD_AVX2;
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        return SIMD_SSE2;
+    #else
+        return SIMD_SCALAR;
+    #endif
+#else
+    return SIMD_SCALAR;
+#endif
+}
+// -------------------------------------------------------------------------------- 
+
+static const simd_kernels* _kernels_for_level(simd_level level) {
+    switch (level) {
+#if defined(C_FLOAT_X86)
+        case SIMD_AVX512: return &AVX512_KERNELS;
+        case SIMD_AVX2:   return &AVX2_KERNELS;
+        case SIMD_SSE2:   return &SSE2_KERNELS;
+#endif
+        default:          return &SCALAR_KERNELS;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Resolves the kernel table on first use
+ *
+ * The C_FLOAT_SIMD environment variable (scalar, sse2, avx2 or avx512) can
+ * lower the selected level for benchmarking; it can never raise it above what
+ * the CPU supports.  Concurrent first calls resolve to the same table, so the
+ * race on the cached pointer is benign.
+ */
+static const simd_kernels* _simd(void) {
+#if defined(__GNUC__) || defined(__clang__)
+    const simd_kernels* kernels = __atomic_load_n(&active_kernels, __ATOMIC_ACQUIRE);
+#else
+    const simd_kernels* kernels = active_kernels;
+#endif
+    if (kernels) return kernels;
+
+    simd_level level = _cpu_simd_level();
+    const char* forced = getenv("C_FLOAT_SIMD");
+    if (forced) {
+        simd_level requested = level;
+        if (strcmp(forced, "scalar") == 0) requested = SIMD_SCALAR;
+        else if (strcmp(forced, "sse2") == 0) requested = SIMD_SSE2;
+        else if (strcmp(forced, "avx2") == 0) requested = SIMD_AVX2;
+        else if (strcmp(forced, "avx512") == 0) requested = SIMD_AVX512;
+        if (requested < level) level = requested;
+    }
+    kernels = _kernels_for_level(level);
+
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(&active_kernels, kernels, __ATOMIC_RELEASE);
+#else
+    active_kernels = kernels;
+#endif
+    return kernels;
+}
+// -------------------------------------------------------------------------------- 
+
+simd_level float_simd_level(void) {
+    return _simd()->level;
+}
+// -------------------------------------------------------------------------------- 
+
+bool set_float_simd_level(simd_level level) {
+    if (level < SIMD_SCALAR || level > SIMD_AVX512) {
+        errno = EINVAL;
+        return false;
+    }
+    if (level > _cpu_simd_level()) {
+        errno = ENOTSUP;
+        return false;
+    }
+    const simd_kernels* kernels = _kernels_for_level(level);
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(&active_kernels, kernels, __ATOMIC_RELEASE);
+#else
+    active_kernels = kernels;
+#endif
+    return true;
+}
+// ================================================================================
+// ================================================================================
+// THREAD POOL
+//
+// A fork-join pool shared by every parallel_* function.  A job applies one
+// function to the task indices 0 .. ntasks - 1; the workers and the submitting
+// thread claim indices from a shared counter until none remain, so uneven
+// tasks balance themselves.  Only one job runs at a time, and a parallel call
+// made from inside a task runs serially instead of waiting on itself.
+
+typedef void (*pool_task)(void* ctx, size_t task);
+
+static const size_t MAX_FLOAT_THREADS = 1024;
+// --------------------------------------------------------------------------------
+
+#if defined(C_FLOAT_THREADS)
+
+typedef struct {
+    pthread_mutex_t submit;   // Held by the thread running a job
+    pthread_mutex_t lock;     // Protects every field below
+    pthread_cond_t work;      // A job was posted or the pool is stopping
+    pthread_cond_t done;      // A worker left the current job
+    pthread_t* threads;
+    size_t nworkers;
+    size_t requested;         // 0 means one thread per online processor
+    bool started;
+    bool stopping;
+    bool exit_registered;
+    unsigned long generation; // Incremented for every posted job
+    pool_task fn;
+    void* ctx;
+    size_t ntasks;
+    size_t limit;             // Workers allowed to join the current job
+    size_t next;              // Next unclaimed task, updated atomically
+    size_t active;            // Workers currently inside a job
+} thread_pool;
+
+static thread_pool pool = {
+    .submit = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER
+};
+static _Thread_local bool in_pool_job = false;
+// --------------------------------------------------------------------------------
+
+static size_t _online_processors(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+}
+// --------------------------------------------------------------------------------
+
+static void _pool_drain(pool_task fn, void* ctx, size_t ntasks) {
+    size_t task;
+    while ((task = __atomic_fetch_add(&pool.next, 1, __ATOMIC_RELAXED)) < ntasks)
+        fn(ctx, task);
+}
+// --------------------------------------------------------------------------------
+
+static void* _pool_worker(void* arg) {
+    unsigned long seen = *(unsigned long*)arg;
+    in_pool_job = true;
+
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (!pool.stopping && pool.generation == seen)
+            pthread_cond_wait(&pool.work, &pool.lock);
+        if (pool.stopping) break;
+
+        // A worker that wakes after its job finished snapshots a job whose
+        // counter is exhausted, so it never touches the stale context
+        seen = pool.generation;
+        if (pool.active >= pool.limit) continue;
+        pool_task fn = pool.fn;
+        void* ctx = pool.ctx;
+        size_t ntasks = pool.ntasks;
+        pool.active++;
+        pthread_mutex_unlock(&pool.lock);
+
+        _pool_drain(fn, ctx, ntasks);
+
+        pthread_mutex_lock(&pool.lock);
+        pool.active--;
+        pthread_cond_broadcast(&pool.done);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+// --------------------------------------------------------------------------------
+
+static void _pool_stop(void) {
+    pthread_mutex_lock(&pool.lock);
+    if (!pool.started) {
+        pthread_mutex_unlock(&pool.lock);
+        return;
+    }
+    pool.stopping = true;
+    pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (size_t i = 0; i < pool.nworkers; i++)
+        pthread_join(pool.threads[i], NULL);
+    free(pool.threads);
+
+    pthread_mutex_lock(&pool.lock);
+    pool.threads = NULL;
+    pool.nworkers = 0;
+    pool.started = false;
+    pool.stopping = false;
+    pthread_mutex_unlock(&pool.lock);
+}
+// --------------------------------------------------------------------------------
+
+void shutdown_float_thread_pool(void) {
+    pthread_mutex_lock(&pool.submit);
+    _pool_stop();
+    pthread_mutex_unlock(&pool.submit);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the workers on first use; called with pool.submit held
+ *
+ * If some threads cannot be created the pool runs with the ones that were.
+ */
+static void _pool_start(void) {
+    pthread_mutex_lock(&pool.lock);
+    size_t count = pool.requested ? pool.requested : _online_processors();
+    static unsigned long first_generation;
+    first_generation = pool.generation;
+    if (!pool.exit_registered) {
+        pool.exit_registered = true;
+        atexit(shutdown_float_thread_pool);
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    pthread_t* threads = NULL;
+    size_t created = 0;
+    if (count > 1) threads = malloc((count - 1) * sizeof(pthread_t));
+    if (threads) {
+        while (created < count - 1 &&
+               pthread_create(&threads[created], NULL, _pool_worker, &first_generation) == 0)
+            created++;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.threads = threads;
+    pool.nworkers = created;
+    pool.started = true;
+    pthread_mutex_unlock(&pool.lock);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Runs fn over ntasks task indices on at most max_threads threads,
+ *        counting the caller
+ */
+static void _pool_run_limited(pool_task fn, void* ctx, size_t ntasks, size_t max_threads) {
+    if (ntasks < 2 || max_threads < 2 || in_pool_job) {
+        for (size_t i = 0; i < ntasks; i++) fn(ctx, i);
+        return;
+    }
+
+    pthread_mutex_lock(&pool.submit);
+    if (!pool.started) _pool_start();
+
+    pthread_mutex_lock(&pool.lock);
+    // Late wakers from the previous job must leave before the counter resets
+    while (pool.active > 0)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pool.fn = fn;
+    pool.ctx = ctx;
+    pool.ntasks = ntasks;
+    pool.limit = max_threads - 1;
+    __atomic_store_n(&pool.next, 0, __ATOMIC_RELAXED);
+    pool.generation++;
+    if (pool.nworkers) pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+
+    in_pool_job = true;
+    _pool_drain(fn, ctx, ntasks);
+    in_pool_job = false;
+
+    // Every task is claimed; wait for the workers still running theirs
+    pthread_mutex_lock(&pool.lock);
+    while (pool.active > 0)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.submit);
+}
+// --------------------------------------------------------------------------------
+
+static void _pool_run(pool_task fn, void* ctx, size_t ntasks) {
+    _pool_run_limited(fn, ctx, ntasks, SIZE_MAX);
+}
+// --------------------------------------------------------------------------------
+
+bool set_float_thread_count(size_t nthreads) {
+    if (nthreads > MAX_FLOAT_THREADS) {
+        errno = EINVAL;
+        return false;
+    }
+    pthread_mutex_lock(&pool.submit);
+    _pool_stop();
+    pthread_mutex_lock(&pool.lock);
+    pool.requested = nthreads;
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.submit);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t float_thread_count(void) {
+    pthread_mutex_lock(&pool.lock);
+    size_t requested = pool.requested;
+    pthread_mutex_unlock(&pool.lock);
+    return requested ? requested : _online_processors();
+}
+// --------------------------------------------------------------------------------
+
+#else
+
+static void _pool_run_limited(pool_task fn, void* ctx, size_t ntasks, size_t max_threads) {
+    (void) max_threads;
+    for (size_t i = 0; i < ntasks; i++) fn(ctx, i);
+}
+// --------------------------------------------------------------------------------
+
+static void _pool_run(pool_task fn, void* ctx, size_t ntasks) {
+    _pool_run_limited(fn, ctx, ntasks, 1);
+}
+// --------------------------------------------------------------------------------
+
+bool set_float_thread_count(size_t nthreads) {
+    if (nthreads > MAX_FLOAT_THREADS) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+size_t float_thread_count(void) {
+    return 1;
+}
+// --------------------------------------------------------------------------------
+
+void shutdown_float_thread_pool(void) {
+}
+
+#endif /* C_FLOAT_THREADS */
+// ================================================================================
+// ================================================================================
+
+float min_float_vector(float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _simd()->min(vec->data, vec->len);
+}
+// -------------------------------------------------------------------------------- 
+
+float max_float_vector(float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _simd()->max(vec->data, vec->len);
+}
+// -------------------------------------------------------------------------------- 
+
+static const size_t PAIRWISE_BLOCK = 512;  // Leaf size for pairwise summation
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Pairwise (cascade) summation on top of a SIMD leaf kernel
+ *
+ * The range is halved until it fits in PAIRWISE_BLOCK elements, which are
+ * summed with the plain vector kernel.  The rounding error grows with
+ * log2(len / PAIRWISE_BLOCK) instead of len, at the throughput of the leaf.
+ * Split points are kept on a 16 element boundary so every leaf starts with
+ * full vectors.
+ */
+static float _sum_pairwise(const simd_kernels* k, const float* data, size_t len) {
+    if (len <= PAIRWISE_BLOCK) return k->sum(data, len);
+    size_t half = (len / 2) & ~(size_t)15;
+    return _sum_pairwise(k, data, half) + _sum_pairwise(k, data + half, len - half);
+}
+// -------------------------------------------------------------------------------- 
+
+static float _sum_sq_diff_pairwise(const simd_kernels* k, const float* data, size_t len,
+                                   float mean) {
+    if (len <= PAIRWISE_BLOCK) return k->sum_sq_diff(data, len, mean);
+    size_t half = (len / 2) & ~(size_t)15;
+    return _sum_sq_diff_pairwise(k, data, half, mean) +
+           _sum_sq_diff_pairwise(k, data + half, len - half, mean);
+}
+// -------------------------------------------------------------------------------- 
+
+static float _sum_range(const float* data, size_t len, sum_mode mode) {
+    const simd_kernels* k = _simd();
+    switch (mode) {
+        case SUM_NAIVE:    return k->sum(data, len);
+        case SUM_KAHAN:    return k->sum_kahan(data, len);
+        case SUM_DOUBLE:   return k->sum_double(data, len);
+        case SUM_PAIRWISE:
+        default:           return _sum_pairwise(k, data, len);
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+float sum_float_vector(float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _sum_range(vec->data, vec->len, SUM_PAIRWISE);
+}
+// -------------------------------------------------------------------------------- 
+
+float sum_float_vector_ex(const float_v* vec, sum_mode mode) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    if (mode < SUM_NAIVE || mode > SUM_DOUBLE) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _sum_range(vec->data, vec->len, mode);
+}
+// -------------------------------------------------------------------------------- 
+
+float average_float_vector(float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _sum_range(vec->data, vec->len, SUM_PAIRWISE) / vec->len;
+}
+// -------------------------------------------------------------------------------- 
+
+float stdev_float_vector(float_v* vec) {
+    if (!vec || !vec->data) {
+        errno = ENODATA;
+        return FLT_MAX;
+    }
+
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return FLT_MAX;
+    }
+
+    if (vec->len == 1) {
+        errno = ENODATA;
+        return FLT_MAX;
+    }
+
+    const simd_kernels* k = _simd();
+    float mean = _sum_pairwise(k, vec->data, vec->len) / vec->len;
+    float sum_sq_diff = _sum_sq_diff_pairwise(k, vec->data, vec->len, mean);
+    if (isinf(sum_sq_diff)) return INFINITY;
+    return sqrtf(sum_sq_diff / vec->len);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Converts a finished accumulator into the public statistics record
+ */
+static float_stats_t _stats_finish(const stats_acc* acc, size_t count) {
+    float_stats_t stats;
+    stats.count = count;
+    stats.nan_count = acc->nan_count;
+    stats.inf_count = acc->pos_inf + acc->neg_inf;
+
+    if (acc->n + stats.inf_count == 0) {
+        errno = ENODATA;
+        stats.min = stats.max = stats.sum = FLT_MAX;
+        stats.mean = stats.variance = stats.stdev = FLT_MAX;
+        return stats;
+    }
+
+    stats.min = acc->min;
+    stats.max = acc->max;
+    if (acc->pos_inf && acc->neg_inf) {
+        stats.sum = stats.mean = NAN;
+    } else if (acc->pos_inf) {
+        stats.sum = stats.mean = INFINITY;
+    } else if (acc->neg_inf) {
+        stats.sum = stats.mean = -INFINITY;
+    } else {
+        stats.sum = (float)(acc->mean * (double)acc->n);
+        stats.mean = (float)acc->mean;
+    }
+
+    // Population variance, matching stdev_float_vector
+    if (stats.inf_count) {
+        stats.variance = stats.stdev = INFINITY;
+    } else {
+        stats.variance = (float)(acc->m2 / (double)acc->n);
+        stats.stdev = sqrtf(stats.variance);
+    }
+    return stats;
+}
+// -------------------------------------------------------------------------------- 
+
+float_stats_t describe_float_vector(const float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        float_stats_t stats = {0};
+        stats.min = stats.max = stats.sum = FLT_MAX;
+        stats.mean = stats.variance = stats.stdev = FLT_MAX;
+        return stats;
+    }
+
+    stats_acc acc;
+    _stats_init(&acc);
+    _simd()->describe(vec->data, vec->len, &acc);
+    return _stats_finish(&acc, vec->len);
+}
+// --------------------------------------------------------------------------------
+
+static const size_t PARALLEL_THRESHOLD = 1024 * 1024;  // Elements before threads pay off
+static const size_t PARALLEL_CHUNK = 64 * 1024;        // 256 KiB per task, sized for L2
+// --------------------------------------------------------------------------------
+
+typedef enum {
+    REDUCE_MIN,
+    REDUCE_MAX,
+    REDUCE_SUM,
+    REDUCE_SQ_DIFF
+} reduce_op;
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    const simd_kernels* k;
+    const float* data;
+    size_t len;
+    reduce_op op;
+    float mean;       // Only used by REDUCE_SQ_DIFF
+    float* partials;  // One result per PARALLEL_CHUNK
+} reduce_job;
+// --------------------------------------------------------------------------------
+
+static float _reduce_range(const simd_kernels* k, const float* data, size_t len,
+                           reduce_op op, float mean) {
+    switch (op) {
+        case REDUCE_MIN:     return k->min(data, len);
+        case REDUCE_MAX:     return k->max(data, len);
+        case REDUCE_SQ_DIFF: return _sum_sq_diff_pairwise(k, data, len, mean);
+        case REDUCE_SUM:
+        default:             return _sum_pairwise(k, data, len);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static void _reduce_task(void* ctx, size_t task) {
+    reduce_job* job = ctx;
+    size_t start = task * PARALLEL_CHUNK;
+    size_t len = job->len - start < PARALLEL_CHUNK ? job->len - start : PARALLEL_CHUNK;
+    job->partials[task] = _reduce_range(job->k, job->data + start, len, job->op, job->mean);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Reduces a range in PARALLEL_CHUNK pieces spread over the thread pool
+ *
+ * The chunk partials are combined in index order with the same kernels, so
+ * the result depends on the chunk size but never on the thread count or on
+ * which thread handled which chunk; a single configured thread walks the
+ * same chunks.  The min and max kernels skip NaN, so a chunk holding one
+ * still contributes its real extreme.  Short ranges or a failed allocation
+ * fall back to the serial reduction.
+ */
+static float _parallel_reduce(const float* data, size_t len, reduce_op op, float mean) {
+    const simd_kernels* k = _simd();
+    if (len < PARALLEL_THRESHOLD)
+        return _reduce_range(k, data, len, op, mean);
+
+    size_t ntasks = (len + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    float* partials = malloc(ntasks * sizeof(float));
+    if (!partials)
+        return _reduce_range(k, data, len, op, mean);
+
+    reduce_job job = {
+        .k = k,
+        .data = data,
+        .len = len,
+        .op = op,
+        .mean = mean,
+        .partials = partials
+    };
+    _pool_run(_reduce_task, &job, ntasks);
+
+    reduce_op combine = (op == REDUCE_SQ_DIFF) ? REDUCE_SUM : op;
+    float result = _reduce_range(k, partials, ntasks, combine, 0.0f);
+    free(partials);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+float parallel_min_float_vector(const float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _parallel_reduce(vec->data, vec->len, REDUCE_MIN, 0.0f);
+}
+// --------------------------------------------------------------------------------
+
+float parallel_max_float_vector(const float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _parallel_reduce(vec->data, vec->len, REDUCE_MAX, 0.0f);
+}
+// --------------------------------------------------------------------------------
+
+float parallel_sum_float_vector(const float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _parallel_reduce(vec->data, vec->len, REDUCE_SUM, 0.0f);
+}
+// --------------------------------------------------------------------------------
+
+float parallel_average_float_vector(const float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _parallel_reduce(vec->data, vec->len, REDUCE_SUM, 0.0f) / vec->len;
+}
+// --------------------------------------------------------------------------------
+
+float parallel_stdev_float_vector(const float_v* vec) {
+    if (!vec || !vec->data || vec->len < 2) {
+        errno = ENODATA;
+        return FLT_MAX;
+    }
+    float mean = _parallel_reduce(vec->data, vec->len, REDUCE_SUM, 0.0f) / vec->len;
+    float sum_sq_diff = _parallel_reduce(vec->data, vec->len, REDUCE_SQ_DIFF, mean);
+    if (isinf(sum_sq_diff)) return INFINITY;
+    return sqrtf(sum_sq_diff / vec->len);
+}
+
+// -------------------------------------------------------------------------------- 
+
+static double _scan_identity(scan_op op) {
+    switch (op) {
+        case SCAN_PROD: return 1.0;
+        case SCAN_MIN:  return INFINITY;
+        case SCAN_MAX:  return -INFINITY;
+        case SCAN_SUM:
+        default:        return 0.0;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+static double _scan_combine(scan_op op, double a, double b) {
+    switch (op) {
+        case SCAN_PROD: return a * b;
+        case SCAN_MIN:  return b < a ? b : a;
+        case SCAN_MAX:  return b > a ? b : a;
+        case SCAN_SUM:
+        default:        return a + b;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Validates the scan arguments and sizes dst to hold the result
+ */
+static bool _scan_prepare(const float_v* src, float_v* dst, scan_op op) {
+    if (!src || !src->data || src->len == 0 || !dst || !dst->data) {
+        errno = EINVAL;
+        return false;
+    }
+    if (op < SCAN_SUM || op > SCAN_MAX) {
+        errno = EINVAL;
+        return false;
+    }
+    if (dst->alloc < src->len) {
+        if (dst->alloc_type == STATIC) {
+            errno = EINVAL;
+            return false;
+        }
+        if (!_vec_resize(dst, src->len)) {
+            return false;
+        }
+    }
+    dst->len = src->len;
+    dst->sorted = false;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+bool scan_float_vector(const float_v* src, float_v* dst, scan_op op) {
+    if (!_scan_prepare(src, dst, op)) return false;
+    _simd()->scan(src->data, dst->data, src->len, op, _scan_identity(op));
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+typedef struct {
+    const simd_kernels* k;
+    const float* src;
+    float* dst;
+    size_t len;
+    scan_op op;
+    double* totals;   // Pass 1: chunk totals, pass 2: exclusive chunk offsets
+} scan_job;
+// -------------------------------------------------------------------------------- 
+
+static void _scan_local_task(void* ctx, size_t task) {
+    scan_job* job = ctx;
+    size_t start = task * PARALLEL_CHUNK;
+    size_t len = job->len - start < PARALLEL_CHUNK ? job->len - start : PARALLEL_CHUNK;
+    job->totals[task] = job->k->scan(job->src + start, job->dst + start, len, job->op,
+                                     _scan_identity(job->op));
+}
+// -------------------------------------------------------------------------------- 
+
+static void _scan_offset_task(void* ctx, size_t task) {
+    scan_job* job = ctx;
+    size_t start = (task + 1) * PARALLEL_CHUNK;
+    size_t len = job->len - start < PARALLEL_CHUNK ? job->len - start : PARALLEL_CHUNK;
+    float* data = job->dst + start;
+    double offset = job->totals[task + 1];
+
+    switch (job->op) {
+        case SCAN_SUM:
+            for (size_t i = 0; i < len; ++i) data[i] = (float)(data[i] + offset);
+            break;
+        case SCAN_PROD:
+            for (size_t i = 0; i < len; ++i) data[i] = (float)(data[i] * offset);
+            break;
+        case SCAN_MIN: {
+            float bound = (float)offset;
+            for (size_t i = 0; i < len; ++i) data[i] = data[i] < bound ? data[i] : bound;
+            break;
+        }
+        case SCAN_MAX:
+        default: {
+            float bound = (float)offset;
+            for (size_t i = 0; i < len; ++i) data[i] = data[i] > bound ? data[i] : bound;
+            break;
+        }
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+bool parallel_scan_float_vector(const float_v* src, float_v* dst, scan_op op) {
+    if (!_scan_prepare(src, dst, op)) return false;
+
+    const simd_kernels* k = _simd();
+    size_t len = src->len;
+    size_t ntasks = (len + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    double* totals = NULL;
+    if (len >= PARALLEL_THRESHOLD)
+        totals = malloc(ntasks * sizeof(double));
+    if (!totals) {
+        k->scan(src->data, dst->data, len, op, _scan_identity(op));
+        return true;
+    }
+
+    scan_job job = {
+        .k = k,
+        .src = src->data,
+        .dst = dst->data,
+        .len = len,
+        .op = op,
+        .totals = totals
+    };
+    _pool_run(_scan_local_task, &job, ntasks);
+
+    // Turn the chunk totals into the offset each chunk must absorb
+    double running = _scan_identity(op);
+    for (size_t i = 0; i < ntasks; ++i) {
+        double total = totals[i];
+        totals[i] = running;
+        running = _scan_combine(op, running, total);
+    }
+    _pool_run(_scan_offset_task, &job, ntasks - 1);
+
+    free(totals);
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+float_v* cum_sum_float_vector(float_v* vec) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    float_v* new_vec = init_float_vector(vec->len);
+    if (!new_vec) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    new_vec->len = vec->len;
+    new_vec->sorted = false;
+    _simd()->scan(vec->data, new_vec->data, vec->len, SCAN_SUM, 0.0);
+
+    // The running sum only turns non-finite at a NaN input or an overflow;
+    // a NaN is an error and an overflow saturates the rest of the output
+    for (size_t i = 0; i < new_vec->len; ++i) {
+        if (isfinite(new_vec->data[i])) continue;
+        if (isnan(vec->data[i])) {
+            free_float_vector(new_vec);
+            errno = EINVAL;
+            return NULL;
+        }
+        for (; i < new_vec->len; ++i)
+            new_vec->data[i] = INFINITY;
+    }
+    return new_vec;
+}
+// -------------------------------------------------------------------------------- 
+
+static float_v* _cum_scan(const float_v* vec, scan_op op) {
+    if (!vec || !vec->data || vec->len == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    float_v* new_vec = init_float_vector(vec->len);
+    if (!new_vec) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    new_vec->len = vec->len;
+    new_vec->sorted = false;
+    _simd()->scan(vec->data, new_vec->data, vec->len, op, _scan_identity(op));
+    return new_vec;
+}
+// -------------------------------------------------------------------------------- 
+
+float_v* cum_prod_float_vector(const float_v* vec) {
+    return _cum_scan(vec, SCAN_PROD);
+}
+// -------------------------------------------------------------------------------- 
+
+float_v* cum_min_float_vector(const float_v* vec) {
+    return _cum_scan(vec, SCAN_MIN);
+}
+// -------------------------------------------------------------------------------- 
+
+float_v* cum_max_float_vector(const float_v* vec) {
+    return _cum_scan(vec, SCAN_MAX);
+}
+// -------------------------------------------------------------------------------- 
+
+static const size_t SAMPLE_OVERSAMPLING = 32;  // Samples per bucket when picking splitters
+static const size_t MAX_SORT_BUCKETS = 1024;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Shared state of one parallel sample sort
+ *
+ * Elements are classified by their radix key against nbuckets - 1 splitters,
+ * so the same code serves both directions.  NaN values go to an extra bucket
+ * at index nbuckets, which keeps them behind every number.
+ */
+typedef struct {
+    float* data;
+    float* tmp;
+    size_t len;
+    iter_dir direction;
+    uint32_t flip;
+    const uint32_t* splitters;
+    size_t nbuckets;          // A power of two
+    size_t nblocks;
+    size_t* counts;           // nblocks rows of nbuckets + 1 counts, then write offsets
+    size_t* bucket_start;     // nbuckets + 2 entries
+} sample_sort_job;
+// -------------------------------------------------------------------------------- 
+
+static inline size_t _sample_bucket(const sample_sort_job* job, float value) {
+    if (isnan(value)) return job->nbuckets;
+    uint32_t key = _radix_key(value, job->flip);
+    size_t b = 0;
+    for (size_t step = job->nbuckets / 2; step > 0; step /= 2)
+        b += (job->splitters[b + step - 1] <= key) ? step : 0;
+    return b;
+}
+// -------------------------------------------------------------------------------- 
+
+static void _sample_count_task(void* ctx, size_t task) {
+    sample_sort_job* job = ctx;
+    size_t* count = job->counts + task * (job->nbuckets + 1);
+    size_t end = (task + 1) * job->len / job->nblocks;
+    for (size_t i = task * job->len / job->nblocks; i < end; ++i)
+        count[_sample_bucket(job, job->data[i])]++;
+}
+// -------------------------------------------------------------------------------- 
+
+static void _sample_scatter_task(void* ctx, size_t task) {
+    sample_sort_job* job = ctx;
+    size_t* offset = job->counts + task * (job->nbuckets + 1);
+    size_t end = (task + 1) * job->len / job->nblocks;
+    for (size_t i = task * job->len / job->nblocks; i < end; ++i) {
+        float value = job->data[i];
+        job->tmp[offset[_sample_bucket(job, value)]++] = value;
+    }
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Sorts one bucket from the scratch buffer back into place
+ *
+ * Large buckets use the radix sort with their own slice of data as the
+ * scratch half; small ones, or any whose histogram cannot be allocated, are
+ * copied back and quicksorted.
+ */
+static void _sample_sort_bucket_task(void* ctx, size_t bucket) {
+    sample_sort_job* job = ctx;
+    size_t start = job->bucket_start[bucket];
+    size_t len = job->bucket_start[bucket + 1] - start;
+    float* src = job->tmp + start;
+    float* dst = job->data + start;
+    if (len == 0) return;
+
+    size_t* counts = NULL;
+    if (bucket < job->nbuckets && len >= RADIX_THRESHOLD)
+        counts = calloc(RADIX_PASSES * RADIX_BUCKETS, sizeof(size_t));
+    if (!counts) {
+        memcpy(dst, src, len * sizeof(float));
+        if (bucket < job->nbuckets && len > 1)
+            _quicksort_float(dst, 0, len - 1, job->direction);
+        return;
+    }
+
+    float* sorted = _radix_sort_buffers(src, dst, len, job->direction, counts);
+    if (sorted != dst)
+        memcpy(dst, sorted, len * sizeof(float));
+    free(counts);
+}
+// -------------------------------------------------------------------------------- 
+
+static int _compare_uint32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @brief Picks nbuckets - 1 splitter keys from a pseudo random sample
+ *
+ * The sample is drawn with a fixed xorshift seed so a given vector is always
+ * split the same way.
+ */
+static uint32_t* _choose_splitters(const float* data, size_t len, size_t nbuckets,
+                                   uint32_t flip) {
+    size_t nsamples = nbuckets * SAMPLE_OVERSAMPLING;
+    uint32_t* sample = malloc(nsamples * sizeof(uint32_t));
+    uint32_t* splitters = malloc((nbuckets - 1) * sizeof(uint32_t));
+    if (!sample || !splitters) {
+        free(sample);
+        free(splitters);
+        return NULL;
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t n = 0;
+    for (size_t i = 0; i < nsamples; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        float value = data[state % len];
+        if (!isnan(value)) sample[n++] = _radix_key(value, flip);
+    }
+    qsort(sample, n, sizeof(uint32_t), _compare_uint32);
+
+    for (size_t b = 1; b < nbuckets; ++b)
+        splitters[b - 1] = n ? sample[b * n / nbuckets] : UINT32_MAX;
+    free(sample);
+    return splitters;
+}
+// -------------------------------------------------------------------------------- 
+
+bool parallel_sort_float_vector(float_v* vec, iter_dir direction, size_t nthreads) {
+    if (!vec || (!vec->data && vec->len > 0)) {
+        errno = EINVAL;
+        return false;
+    }
+    if ((direction != FORWARD && direction != REVERSE) || nthreads > MAX_FLOAT_THREADS) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t threads = float_thread_count();
+    if (nthreads && nthreads < threads) threads = nthreads;
+    if (vec->len < PARALLEL_THRESHOLD || threads < 2)
+        return sort_float_vector_ex(vec, direction, SORT_AUTO);
+
+    size_t nbuckets = 2;
+    while (nbuckets < 8 * threads && nbuckets < MAX_SORT_BUCKETS) nbuckets *= 2;
+    size_t nblocks = 4 * threads;
+    uint32_t flip = direction == REVERSE ? UINT32_MAX : 0;
+
+    float* tmp = malloc(vec->len * sizeof(float));
+    size_t* counts = calloc(nblocks * (nbuckets + 1), sizeof(size_t));
+    size_t* bucket_start = malloc((nbuckets + 2) * sizeof(size_t));
+    uint32_t* splitters = _choose_splitters(vec->data, vec->len, nbuckets, flip);
+    if (!tmp || !counts || !bucket_start || !splitters) {
+        free(tmp);
+        free(counts);
+        free(bucket_start);
+        free(splitters);
+        return sort_float_vector_ex(vec, direction, SORT_AUTO);
+    }
+
+    sample_sort_job job = {
+        .data = vec->data,
+        .tmp = tmp,
+        .len = vec->len,
+        .direction = direction,
+        .flip = flip,
+        .splitters = splitters,
+        .nbuckets = nbuckets,
+        .nblocks = nblocks,
+        .counts = counts,
+        .bucket_start = bucket_start
+    };
+    _pool_run_limited(_sample_count_task, &job, nblocks, threads);
+
+    // Bucket by bucket, each block writes after the blocks before it, which
+    // keeps the scatter stable and lets every block write without locking
+    size_t offset = 0;
+    for (size_t b = 0; b <= nbuckets; ++b) {
+        bucket_start[b] = offset;
+        for (size_t t = 0; t < nblocks; ++t) {
+            size_t* count = &counts[t * (nbuckets + 1) + b];
+            size_t c = *count;
+            *count = offset;
+            offset += c;
+        }
+    }
+    bucket_start[nbuckets + 1] = offset;
+
+    _pool_run_limited(_sample_scatter_task, &job, nblocks, threads);
+    _pool_run_limited(_sample_sort_bucket_task, &job, nbuckets + 1, threads);
+
+    free(tmp);
+    free(counts);
+    free(bucket_start);
+    free(splitters);
+    vec->sorted = direction == FORWARD;
+    return true;
+}
+// -------------------------------------------------------------------------------- 
+
+float_v* copy_float_vector(const float_v* original) {
+    if (!original) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    float_v* copy = init_float_vector(original->alloc + original->front);
+    if (!copy) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < original->len; ++i) {
+        if (!push_back_float_vector(copy, original->data[i])) {
+            free_float_vector(copy);
+            return NULL;
+        }
+    }
+
+    return copy;
+}
+// ================================================================================
+// ================================================================================
+// SEGMENTED VECTOR IMPLEMENTATION
+//
+// A float_sv stores its elements in chunks of a fixed power-of-two size.  The
+// chunk directory is the only array that is ever reallocated, and it holds
+// one pointer per chunk, so growth copies no elements and a pointer to an
+// element stays valid until the vector is freed.
+
+#define FLOAT_SV_CHUNK ((size_t)1 << 16)  // Default chunk size in elements (256 KiB)
+#define FLOAT_SV_MIN_SHIFT 4              // Chunks hold at least 16 elements
+#define FLOAT_SV_MAX_SHIFT 40
+
+struct float_sv {
+    float** chunks;    // Chunk directory; a chunk never moves once allocated
+    size_t nchunks;    // Chunks allocated
+    size_t dir_alloc;  // Capacity of the directory
+    size_t len;        // Number of elements
+    size_t shift;      // log2 of the chunk size
+};
+// --------------------------------------------------------------------------------
+
+float_sv* init_float_seg_vector(size_t chunk_size) {
+    size_t shift = FLOAT_SV_MIN_SHIFT;
+    if (chunk_size == 0) {
+        chunk_size = FLOAT_SV_CHUNK;
+    }
+    while (shift < FLOAT_SV_MAX_SHIFT && ((size_t)1 << shift) < chunk_size) {
+        shift++;
+    }
+    if (((size_t)1 << shift) < chunk_size) {
+        errno = EINVAL;
+        return NULL;
+    }
+    float_sv* vec = calloc(1, sizeof(float_sv));
+    if (!vec) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    vec->shift = shift;
+    return vec;
+}
+// --------------------------------------------------------------------------------
+
+void free_float_seg_vector(float_sv* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return;
+    }
+    for (size_t i = 0; i < vec->nchunks; i++) {
+        free(vec->chunks[i]);
+    }
+    free(vec->chunks);
+    free(vec);
+}
+// --------------------------------------------------------------------------------
+
+void _free_float_seg_vector(float_sv** vec) {
+    if (vec && *vec) {
+        free_float_seg_vector(*vec);
+        *vec = NULL;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static bool _sv_add_chunk(float_sv* vec) {
+    if (vec->nchunks == vec->dir_alloc) {
+        size_t new_alloc = vec->dir_alloc == 0 ? 8 : vec->dir_alloc * 2;
+        if (new_alloc > SIZE_MAX / sizeof(float*)) {
+            errno = ERANGE;
+            return false;
+        }
+        float** chunks = realloc(vec->chunks, new_alloc * sizeof(float*));
+        if (!chunks) {
+            errno = ENOMEM;
+            return false;
+        }
+        vec->chunks = chunks;
+        vec->dir_alloc = new_alloc;
+    }
+    float* chunk = malloc(sizeof(float) << vec->shift);
+    if (!chunk) {
+        errno = ENOMEM;
+        return false;
+    }
+    vec->chunks[vec->nchunks++] = chunk;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool push_back_float_seg_vector(float_sv* vec, float value) {
+    if (!vec) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t chunk = vec->len >> vec->shift;
+    if (chunk == vec->nchunks && !_sv_add_chunk(vec)) {
+        return false;
+    }
+    vec->chunks[chunk][vec->len & (((size_t)1 << vec->shift) - 1)] = value;
+    vec->len++;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool append_float_seg_vector(float_sv* vec, const float* values, size_t count) {
+    if (!vec || (!values && count > 0)) {
+        errno = EINVAL;
+        return false;
+    }
+    const size_t size = (size_t)1 << vec->shift;
+    while (count > 0) {
+        size_t chunk = vec->len >> vec->shift;
+        if (chunk == vec->nchunks && !_sv_add_chunk(vec)) {
+            return false;
+        }
+        size_t offset = vec->len & (size - 1);
+        size_t n = size - offset < count ? size - offset : count;
+        memcpy(vec->chunks[chunk] + offset, values, n * sizeof(float));
+        vec->len += n;
+        values += n;
+        count -= n;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+float pop_back_float_seg_vector(float_sv* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return FLT_MAX;
+    }
+    vec->len--;
+    return vec->chunks[vec->len >> vec->shift][vec->len & (((size_t)1 << vec->shift) - 1)];
+}
+// --------------------------------------------------------------------------------
+
+float float_seg_vector_index(const float_sv* vec, size_t index) {
+    if (!vec) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    if (index >= vec->len) {
+        errno = ERANGE;
+        return FLT_MAX;
+    }
+    return vec->chunks[index >> vec->shift][index & (((size_t)1 << vec->shift) - 1)];
+}
+// --------------------------------------------------------------------------------
+
+float* float_seg_vector_ptr(float_sv* vec, size_t index) {
+    if (!vec) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (index >= vec->len) {
+        errno = ERANGE;
+        return NULL;
+    }
+    return &vec->chunks[index >> vec->shift][index & (((size_t)1 << vec->shift) - 1)];
+}
+// --------------------------------------------------------------------------------
+
+size_t float_seg_vector_size(const float_sv* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return vec->len;
+}
+// --------------------------------------------------------------------------------
+
+size_t float_seg_vector_alloc(const float_sv* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return vec->nchunks << vec->shift;
+}
+// --------------------------------------------------------------------------------
+
+size_t float_seg_vector_chunk_size(const float_sv* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return (size_t)1 << vec->shift;
+}
+// --------------------------------------------------------------------------------
+
+size_t float_seg_vector_chunks(const float_sv* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return LONG_MAX;
+    }
+    return (vec->len + ((size_t)1 << vec->shift) - 1) >> vec->shift;
+}
+// --------------------------------------------------------------------------------
+
+const float* float_seg_vector_chunk(const float_sv* vec, size_t chunk, size_t* len) {
+    if (!vec || !len) {
+        errno = EINVAL;
+        return NULL;
+    }
+    const size_t size = (size_t)1 << vec->shift;
+    if (chunk >= (vec->len + size - 1) >> vec->shift) {
+        errno = ERANGE;
+        return NULL;
+    }
+    size_t start = chunk << vec->shift;
+    *len = vec->len - start < size ? vec->len - start : size;
+    return vec->chunks[chunk];
+}
+// --------------------------------------------------------------------------------
+
+float min_float_seg_vector(const float_sv* vec) {
+    if (!vec || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    const simd_kernels* k = _simd();
+    const size_t size = (size_t)1 << vec->shift;
+    // Chunks merge the way _min_scalar walks elements: the kernels skip NaN,
+    // and so does the comparison, so every chunk's min counts
+    float result = FLT_MAX;
+    for (size_t start = 0, c = 0; start < vec->len; start += size, c++) {
+        float m = k->min(vec->chunks[c], vec->len - start < size ? vec->len - start : size);
+        if (m < result) result = m;
+    }
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+float max_float_seg_vector(const float_sv* vec) {
+    if (!vec || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    const simd_kernels* k = _simd();
+    const size_t size = (size_t)1 << vec->shift;
+    // Chunks merge the way _max_scalar walks elements: the kernels skip NaN,
+    // and so does the comparison, so every chunk's max counts
+    float result = -FLT_MAX;
+    for (size_t start = 0, c = 0; start < vec->len; start += size, c++) {
+        float m = k->max(vec->chunks[c], vec->len - start < size ? vec->len - start : size);
+        if (m > result) result = m;
+    }
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+float sum_float_seg_vector(const float_sv* vec, sum_mode mode) {
+    if (!vec || vec->len == 0 || mode < SUM_NAIVE || mode > SUM_DOUBLE) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    // Each chunk is summed with the requested kernel and the chunk sums are
+    // added in double, so the chunk boundaries add no rounding of their own
+    const size_t size = (size_t)1 << vec->shift;
+    double total = 0.0;
+    for (size_t start = 0, c = 0; start < vec->len; start += size, c++) {
+        total += _sum_range(vec->chunks[c], vec->len - start < size ? vec->len - start : size,
+                            mode);
+    }
+    return (float)total;
+}
+// --------------------------------------------------------------------------------
+
+float average_float_seg_vector(const float_sv* vec) {
+    if (!vec || vec->len == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return sum_float_seg_vector(vec, SUM_PAIRWISE) / vec->len;
+}
+// --------------------------------------------------------------------------------
+
+float_v* flatten_float_seg_vector(const float_sv* vec) {
+    if (!vec) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (vec->len == 0) {
+        errno = ENODATA;
+        return NULL;
+    }
+    float_v* flat = init_float_vector(vec->len);
+    if (!flat) {
+        return NULL;
+    }
+    const size_t size = (size_t)1 << vec->shift;
+    for (size_t start = 0, c = 0; start < vec->len; start += size, c++) {
+        memcpy(flat->data + start, vec->chunks[c],
+               (vec->len - start < size ? vec->len - start : size) * sizeof(float));
+    }
+    flat->len = vec->len;
+    flat->sorted = vec->len <= 1;
+    return flat;
+}
+// ================================================================================
+// ================================================================================
+// DICTIONARY IMPLEMENTATION
+//
+// Entry arena.  Chain nodes and key strings of one dictionary are carved from a few large
+// slabs instead of costing one malloc each, so a node and its key usually
+// share a cache line.  Block sizes are rounded up to 8 bytes.  A freed block
+// of up to DICT_ARENA_SMALL bytes joins a free list for its size and is
+// handed out again before the slab is bumped.  Longer keys get a block of
+// their own on a doubly linked list.  Clearing or freeing a dictionary
+// releases the slabs wholesale without visiting entries.
+
+#define DICT_SLAB_MIN ((size_t)4096)
+#define DICT_SLAB_MAX ((size_t)1 << 20)
+#define DICT_ARENA_SMALL 256
+#define DICT_ARENA_ALIGN 8
+
+typedef struct dict_slab {
+    struct dict_slab* next;
+    max_align_t data[];
+} dict_slab;
+// --------------------------------------------------------------------------------
+
+typedef struct dict_big {
+    struct dict_big* prev;
+    struct dict_big* next;
+    max_align_t data[];
+} dict_big;
+// --------------------------------------------------------------------------------
+
+typedef struct {
+    dict_slab* slabs;   // Newest first, the head is the one being bumped
+    char* bump;         // Next free byte of the head slab
+    size_t bump_left;   // Bytes left in the head slab
+    size_t slab_size;   // Size of the next slab, doubling up to DICT_SLAB_MAX
+    dict_big* big;      // Blocks larger than DICT_ARENA_SMALL
+    size_t live_bytes;  // Small-block bytes in use, so a clone can size one slab
+    void* free_blocks[DICT_ARENA_SMALL / DICT_ARENA_ALIGN];  // Recycled blocks by size
+} dict_arena;
+// --------------------------------------------------------------------------------
+
+static inline size_t _arena_round(size_t size) {
+    return (size + DICT_ARENA_ALIGN - 1) & ~(size_t)(DICT_ARENA_ALIGN - 1);
+}
+// --------------------------------------------------------------------------------
+
+static void* _arena_alloc(dict_arena* arena, size_t size) {
+    size = _arena_round(size);
+    if (size > DICT_ARENA_SMALL) {
+        dict_big* big = malloc(sizeof(dict_big) + size);
+        if (!big) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        big->prev = NULL;
+        big->next = arena->big;
+        if (arena->big) arena->big->prev = big;
+        arena->big = big;
+        return big->data;
+    }
+
+    void** head = &arena->free_blocks[size / DICT_ARENA_ALIGN - 1];
+    if (*head) {
+        void* block = *head;
+        *head = *(void**)block;
+        arena->live_bytes += size;
+        return block;
+    }
+
+    if (size > arena->bump_left) {
+        // The unused tail of the previous slab is at most DICT_ARENA_SMALL bytes
+        size_t slab_size = arena->slab_size ? arena->slab_size : DICT_SLAB_MIN;
+        dict_slab* slab = malloc(sizeof(dict_slab) + slab_size);
+        if (!slab) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        slab->next = arena->slabs;
+        arena->slabs = slab;
+        arena->bump = (char*)slab->data;
+        arena->bump_left = slab_size;
+        arena->slab_size = slab_size < DICT_SLAB_MAX ? slab_size * 2 : DICT_SLAB_MAX;
+    }
+    void* block = arena->bump;
+    arena->bump += size;
+    arena->bump_left -= size;
+    arena->live_bytes += size;
+    return block;
+}
+// --------------------------------------------------------------------------------
+
+static void _arena_free(dict_arena* arena, void* block, size_t size) {
+    size = _arena_round(size);
+    if (size > DICT_ARENA_SMALL) {
+        dict_big* big = (dict_big*)((char*)block - offsetof(dict_big, data));
+        if (big->prev) {
+            big->prev->next = big->next;
+        } else {
+            arena->big = big->next;
+        }
+        if (big->next) big->next->prev = big->prev;
+        free(big);
+        return;
+    }
+    void** head = &arena->free_blocks[size / DICT_ARENA_ALIGN - 1];
+    *(void**)block = *head;
+    *head = block;
+    arena->live_bytes -= size;
+}
+// --------------------------------------------------------------------------------
+
+static bool _arena_reserve(dict_arena* arena, size_t bytes) {
+    // Starts a slab that serves the next bytes of small blocks without
+    // another malloc
+    if (bytes <= arena->bump_left) return true;
+    dict_slab* slab = malloc(sizeof(dict_slab) + bytes);
+    if (!slab) {
+        errno = ENOMEM;
+        return false;
+    }
+    slab->next = arena->slabs;
+    arena->slabs = slab;
+    arena->bump = (char*)slab->data;
+    arena->bump_left = bytes;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void _arena_release(dict_arena* arena) {
+    // Frees every block at once and leaves the arena empty and reusable
+    for (dict_slab* slab = arena->slabs; slab;) {
+        dict_slab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    for (dict_big* big = arena->big; big;) {
+        dict_big* next = big->next;
+        free(big);
+        big = next;
+    }
+    memset(arena, 0, sizeof(*arena));
+}
+// ================================================================================
+// ================================================================================
+// ENTRIES AND HASHING
+
+typedef struct {
+    char* key;
+    size_t key_len;  // Cached so lookups compare lengths before bytes
+    size_t hash;     // Cached so resizing never hashes a key again
+    size_t next;     // DICT_CHAINED: next entry in the same bucket
+} fdictEntry;
+// --------------------------------------------------------------------------------
+
+#define DICT_NONE SIZE_MAX  // Empty bucket or end of a chain
+
+/*
+ * Entries are stored densely in insertion order, and values[i] holds the
+ * value of entries[i], so the values form one contiguous array.  The hash
+ * table maps keys to entry indices: bucket heads linked through
+ * fdictEntry.next for DICT_CHAINED, control bytes and slots for DICT_OPEN.
+ * Removing an entry moves the last entry into its place.
+ */
+struct dict_f {
+    dict_backend backend;
+    fdictEntry* entries;   // hash_size entries in insertion order
+    float* values;         // Parallel to entries
+    size_t entry_alloc;    // Capacity of entries and values
+    size_t* heads;         // DICT_CHAINED: first entry of each bucket
+    uint8_t* ctrl;         // DICT_OPEN: one control byte per slot
+    size_t* slots;         // DICT_OPEN: entry index of each full slot
+    size_t hash_size;      // Number of entries
+    size_t len;            // Occupied buckets or slots
+    size_t alloc;          // Number of buckets or slots
+    size_t tombstones;     // DICT_OPEN: deleted slots that still extend probe chains
+    bool incremental;      // Spread each resize over the mutations that follow it
+    size_t old_alloc;      // Size of the table being drained, 0 when no resize is pending
+    size_t rehash_pos;     // Next old bucket or slot to migrate
+    size_t* old_heads;     // DICT_CHAINED: table being drained
+    uint8_t* old_ctrl;     // DICT_OPEN: table being drained
+    size_t* old_slots;
+    dict_hash_fn hash_fn;  // Hashes every key of this dictionary
+    uint64_t seed;         // Per-dictionary, so collisions do not carry over
+    dict_arena arena;      // Keys
+    float_file* view;      // LOAD_MAP: mapping that holds the loaded keys
+    bool view_values;      // values still points into view
+};
+// --------------------------------------------------------------------------------
+
+/*
+ * Both built-in hashes read the key through memcpy, which compiles to plain
+ * loads but does not assume the key is aligned.
+ */
+static inline uint64_t _read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --------------------------------------------------------------------------------
+
+size_t c_float_hash_murmur3(const char* key, size_t len, uint64_t seed) {
+    if (!key) {
+        return 0;
+    }
+
+    // Constants for mixing
+    const uint32_t c1 = 0xcc9e2d51;
+    const uint32_t c2 = 0x1b873593;
+    uint32_t h1 = (uint32_t)seed ^ (uint32_t)(seed >> 32);
+
+    // Process key in 4-byte chunks
+    const uint8_t* data = (const uint8_t*)key;
+    const size_t nblocks = len / 4;
+
+    // Body
+    for (size_t i = 0; i < nblocks; i++) {
+        uint32_t k1 = (uint32_t)_read32(data + i * 4);
+
+        k1 *= c1;
+        k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
+        k1 *= c2;
+
+        h1 ^= k1;
+        h1 = (h1 << 13) | (h1 >> 19);  // ROTL32(h1, 13)
+        h1 = h1 * 5 + 0xe6546b64;
+    }
+
+    // Tail
+    const uint8_t* tail = data + nblocks * 4;
+    uint32_t k1 = 0;
+
+    switch (len & 3) {
+        case 3:
+            k1 ^= (uint32_t)tail[2] << 16;
+            /* fallthrough */
+        case 2:
+            k1 ^= (uint32_t)tail[1] << 8;
+            /* fallthrough */
+        case 1:
+            k1 ^= tail[0];
+            k1 *= c1;
+            k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
+            k1 *= c2;
+            h1 ^= k1;
+    }
+
+    // Finalization
+    h1 ^= (uint32_t)len;
+    h1 ^= h1 >> 16;
+    h1 *= 0x85ebca6b;
+    h1 ^= h1 >> 13;
+    h1 *= 0xc2b2ae35;
+    h1 ^= h1 >> 16;
+
+    return (size_t)h1;
+}
+// --------------------------------------------------------------------------------
+
+static inline void _wymum(uint64_t* a, uint64_t* b) {
+    // Full 64 x 64 -> 128 bit product, low half in a and high half in b
+#if defined(__SIZEOF_INT128__)
+    __extension__ unsigned __int128 r = (unsigned __int128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    const uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _wymix(uint64_t a, uint64_t b) {
+    _wymum(&a, &b);
+    return a ^ b;
+}
+// --------------------------------------------------------------------------------
+
+static const uint64_t _wyp[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+// --------------------------------------------------------------------------------
+
+size_t c_float_hash_wy(const char* key, size_t len, uint64_t seed) {
+    // wyhash (final version 4).  Keys of up to 16 bytes take two or four
+    // overlapping loads and one multiply; longer keys are consumed 16 or 48
+    // bytes per step by independent multiply chains.
+    if (!key) {
+        return 0;
+    }
+    const uint8_t* p = (const uint8_t*)key;
+    seed ^= _wymix(seed ^ _wyp[0], _wyp[1]);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            const size_t shift = (len >> 3) << 2;
+            a = (_read32(p) << 32) | _read32(p + shift);
+            b = (_read32(p + len - 4) << 32) | _read32(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = _wymix(_read64(p) ^ _wyp[1], _read64(p + 8) ^ seed);
+                see1 = _wymix(_read64(p + 16) ^ _wyp[2], _read64(p + 24) ^ see1);
+                see2 = _wymix(_read64(p + 32) ^ _wyp[3], _read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = _wymix(_read64(p) ^ _wyp[1], _read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = _read64(p + i - 16);
+        b = _read64(p + i - 8);
+    }
+    a ^= _wyp[1];
+    b ^= seed;
+    _wymum(&a, &b);
+    return (size_t)_wymix(a ^ _wyp[0] ^ len, b ^ _wyp[1]);
+}
+// --------------------------------------------------------------------------------
+
+static uint64_t _dict_seed(const void* owner) {
+    // Every dictionary gets its own seed so that keys chosen to collide in
+    // one process, or one dictionary, do not collide in another.  The kernel
+    // supplies it where it can; otherwise a process-wide counter is mixed
+    // with the clock and the dictionary's address.
+#if defined(__linux__)
+    uint64_t random;
+    if (getrandom(&random, sizeof(random), GRND_NONBLOCK) == (ssize_t)sizeof(random)) {
+        return random;
+    }
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+    static uint64_t counter;
+    uint64_t x = __atomic_add_fetch(&counter, 0x9e3779b97f4a7c15ull, __ATOMIC_RELAXED);
+#else
+    static uint64_t counter;
+    uint64_t x = counter += 0x9e3779b97f4a7c15ull;
+#endif
+    x ^= (uint64_t)time(NULL) ^ ((uint64_t)(uintptr_t)owner << 16) ^ (uint64_t)clock();
+    // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+// --------------------------------------------------------------------------------
+
+uint64_t c_float_random_seed(void) {
+    uint64_t local = 0;
+    return _dict_seed(&local);
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief A lookup key with its length and hash, computed once per call
+ */
+typedef struct {
+    const char* key;
+    size_t len;
+    size_t hash;
+} hashed_key;
+// --------------------------------------------------------------------------------
+
+static inline hashed_key _hash_key(const char* key, dict_hash_fn hash, uint64_t seed) {
+    // The length is measured once and the hash reads exactly that many bytes.
+    // The default hash is called directly so it can be inlined.
+    size_t len = strlen(key);
+    size_t h = hash == c_float_hash_wy ? c_float_hash_wy(key, len, seed) : hash(key, len, seed);
+    return (hashed_key){key, len, h};
+}
+// --------------------------------------------------------------------------------
+
+static inline bool _key_equal(const char* stored, size_t stored_len, size_t stored_hash,
+                              const hashed_key* key) {
+    // The cached hash and length reject almost every mismatch before the key
+    // bytes are read
+    return stored_hash == key->hash && stored_len == key->len &&
+           memcmp(stored, key->key, key->len) == 0;
+}
+// --------------------------------------------------------------------------------
+
+static char* _key_copy(dict_arena* arena, const hashed_key* key) {
+    char* copy = _arena_alloc(arena, key->len + 1);
+    if (!copy) return NULL;  // errno set by _arena_alloc
+    memcpy(copy, key->key, key->len + 1);
+    return copy;
+}
+// --------------------------------------------------------------------------------
+
+static bool _entries_reserve(dict_f* dict, size_t capacity) {
+    // Entries and values grow together so each value keeps its entry's index
+    if (capacity <= dict->entry_alloc) return true;
+    if (capacity > SIZE_MAX / sizeof(fdictEntry)) {
+        errno = ENOMEM;
+        return false;
+    }
+    fdictEntry* entries = realloc(dict->entries, capacity * sizeof(fdictEntry));
+    if (!entries) {
+        errno = ENOMEM;
+        return false;
+    }
+    dict->entries = entries;
+    // Values viewed in a mapping move to the heap the first time they grow
+    float* values = dict->view_values ? malloc(capacity * sizeof(float))
+                                      : realloc(dict->values, capacity * sizeof(float));
+    if (!values) {
+        errno = ENOMEM;
+        return false;
+    }
+    if (dict->view_values) {
+        memcpy(values, dict->values, dict->hash_size * sizeof(float));
+        dict->view_values = false;
+    }
+    dict->values = values;
+    dict->entry_alloc = capacity;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static size_t _entries_push(dict_f* dict, const hashed_key* key, float value) {
+    // Appends an entry for the caller to link into the table.  Returns its
+    // index, or DICT_NONE if allocation fails.
+    if (dict->hash_size == dict->entry_alloc) {
+        size_t capacity = dict->entry_alloc < VEC_THRESHOLD
+                          ? dict->entry_alloc * 2 : dict->entry_alloc + VEC_FIXED_AMOUNT;
+        if (!_entries_reserve(dict, capacity)) return DICT_NONE;
+    }
+    char* new_key = _key_copy(&dict->arena, key);
+    if (!new_key) return DICT_NONE;
+
+    const size_t index = dict->hash_size++;
+    dict->entries[index] = (fdictEntry){new_key, key->len, key->hash, DICT_NONE};
+    dict->values[index] = value;
+    return index;
+}
+// ================================================================================
+// ================================================================================
+// OPEN ADDRESSING ENGINE
+//
+// Slots are probed a group of 16 at a time.  Every slot has a control byte:
+// EMPTY, DELETED, or the low seven bits of its key's hash (the tag) when full.
+// One SSE2 compare checks all 16 tags in a group against the tag being looked
+// up, so the key is compared only for the rare slots whose tag matches.
+// Probing stops at the first group that holds an EMPTY byte.  Groups are
+// visited in triangular order, which reaches every group of a power-of-two
+// table.  A full slot holds the index of its entry.
+//
+// While an incremental resize is pending, entries live in either the new
+// table or the old one.  Positions returned by _open_find below alloc index
+// the new table and positions from alloc upward index the old table.
+
+#define CTRL_EMPTY ((uint8_t)0x80)
+#define CTRL_DELETED ((uint8_t)0xFE)
+#define DICT_GROUP 16
+#define DICT_REHASH_STEP 64  // Old buckets or slots migrated per mutation
+
+static inline unsigned _ctz32(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(x);
+#else
+    unsigned n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline uint32_t _group_match(const uint8_t* ctrl, uint8_t tag) {
+    // Bit i is set when control byte i of the group equals tag
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+#else
+    uint32_t mask = 0;
+    for (unsigned i = 0; i < DICT_GROUP; i++) mask |= (uint32_t)(ctrl[i] == tag) << i;
+    return mask;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline uint32_t _group_free(const uint8_t* ctrl) {
+    // EMPTY and DELETED are the only control bytes with the high bit set
+#if defined(__SSE2__)
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+#else
+    uint32_t mask = 0;
+    for (unsigned i = 0; i < DICT_GROUP; i++) mask |= (uint32_t)(ctrl[i] >> 7) << i;
+    return mask;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline uint8_t _hash_tag(size_t hash) {
+    return (uint8_t)(hash & 0x7F);
+}
+// --------------------------------------------------------------------------------
+
+static inline size_t _hash_group(size_t hash, size_t alloc) {
+    return (hash >> 7) & (alloc / DICT_GROUP - 1);
+}
+// --------------------------------------------------------------------------------
+
+static size_t _open_probe(const dict_f* dict, const uint8_t* ctrl, const size_t* slots,
+                          size_t alloc, const hashed_key* key, size_t* free_slot) {
+    // When free_slot is given, the same pass records the first EMPTY or
+    // DELETED slot on the probe path, which is where an insert would go
+    const size_t mask = alloc / DICT_GROUP - 1;
+    const uint8_t tag = _hash_tag(key->hash);
+    size_t group = _hash_group(key->hash, alloc);
+    for (size_t step = 1; step <= mask + 1; step++) {
+        const uint8_t* group_ctrl = ctrl + group * DICT_GROUP;
+        for (uint32_t match = _group_match(group_ctrl, tag); match; match &= match - 1) {
+            size_t slot = group * DICT_GROUP + _ctz32(match);
+            const fdictEntry* entry = &dict->entries[slots[slot]];
+            if (_key_equal(entry->key, entry->key_len, entry->hash, key)) return slot;
+        }
+        if (free_slot && *free_slot == SIZE_MAX) {
+            uint32_t free_slots = _group_free(group_ctrl);
+            if (free_slots) *free_slot = group * DICT_GROUP + _ctz32(free_slots);
+        }
+        if (_group_match(group_ctrl, CTRL_EMPTY)) break;
+        group = (group + step) & mask;
+    }
+    return SIZE_MAX;
+}
+// --------------------------------------------------------------------------------
+
+static size_t _open_probe_index(const uint8_t* ctrl, const size_t* slots, size_t alloc,
+                                size_t hash, size_t index) {
+    // Finds the slot holding entry index.  Matching the index instead of the
+    // key means no key bytes are read.
+    const size_t mask = alloc / DICT_GROUP - 1;
+    const uint8_t tag = _hash_tag(hash);
+    size_t group = _hash_group(hash, alloc);
+    for (size_t step = 1; step <= mask + 1; step++) {
+        const uint8_t* group_ctrl = ctrl + group * DICT_GROUP;
+        for (uint32_t match = _group_match(group_ctrl, tag); match; match &= match - 1) {
+            size_t slot = group * DICT_GROUP + _ctz32(match);
+            if (slots[slot] == index) return slot;
+        }
+        if (_group_match(group_ctrl, CTRL_EMPTY)) break;
+        group = (group + step) & mask;
+    }
+    return SIZE_MAX;
+}
+// --------------------------------------------------------------------------------
+
+static size_t _open_find(const dict_f* dict, const hashed_key* key) {
+    size_t slot = _open_probe(dict, dict->ctrl, dict->slots, dict->alloc, key, NULL);
+    if (slot != SIZE_MAX || !dict->old_alloc) return slot;
+    slot = _open_probe(dict, dict->old_ctrl, dict->old_slots, dict->old_alloc, key, NULL);
+    return slot == SIZE_MAX ? SIZE_MAX : dict->alloc + slot;
+}
+// --------------------------------------------------------------------------------
+
+static inline size_t* _open_slot(const dict_f* dict, size_t pos) {
+    return pos < dict->alloc ? &dict->slots[pos] : &dict->old_slots[pos - dict->alloc];
+}
+// --------------------------------------------------------------------------------
+
+static size_t* _open_ref(const dict_f* dict, size_t index) {
+    // The slot that refers to entry index, in whichever table holds it
+    const size_t hash = dict->entries[index].hash;
+    size_t slot = _open_probe_index(dict->ctrl, dict->slots, dict->alloc, hash, index);
+    if (slot != SIZE_MAX) return &dict->slots[slot];
+    slot = _open_probe_index(dict->old_ctrl, dict->old_slots, dict->old_alloc, hash, index);
+    return &dict->old_slots[slot];
+}
+// --------------------------------------------------------------------------------
+
+static size_t _open_free_slot(const uint8_t* ctrl, size_t alloc, size_t hash) {
+    // The load limit keeps free slots in the table, so the probe always ends
+    const size_t mask = alloc / DICT_GROUP - 1;
+    size_t group = _hash_group(hash, alloc);
+    for (size_t step = 1; ; step++) {
+        uint32_t free_slots = _group_free(ctrl + group * DICT_GROUP);
+        if (free_slots) return group * DICT_GROUP + _ctz32(free_slots);
+        group = (group + step) & mask;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline void _open_place(dict_f* dict, size_t slot, size_t index) {
+    if (dict->ctrl[slot] == CTRL_DELETED) dict->tombstones--;
+    dict->ctrl[slot] = _hash_tag(dict->entries[index].hash);
+    dict->slots[slot] = index;
+}
+// --------------------------------------------------------------------------------
+
+static bool _open_alloc_table(dict_f* dict, size_t alloc) {
+    uint8_t* ctrl = malloc(alloc);
+    size_t* slots = malloc(alloc * sizeof(size_t));
+    if (!ctrl || !slots) {
+        free(ctrl);
+        free(slots);
+        errno = ENOMEM;
+        return false;
+    }
+    memset(ctrl, CTRL_EMPTY, alloc);
+    dict->ctrl = ctrl;
+    dict->slots = slots;
+    dict->alloc = alloc;
+    dict->tombstones = 0;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void _open_migrate(dict_f* dict, size_t count) {
+    // Moves the next count old slots into the new table.  A moved slot is
+    // marked DELETED so the probe chains of keys still waiting in the old
+    // table stay intact.
+    const size_t end = count < dict->old_alloc - dict->rehash_pos
+                       ? dict->rehash_pos + count : dict->old_alloc;
+    for (size_t i = dict->rehash_pos; i < end; i++) {
+        if (dict->old_ctrl[i] & 0x80) continue;
+        // The cached hash places the entry without reading its key
+        size_t index = dict->old_slots[i];
+        _open_place(dict, _open_free_slot(dict->ctrl, dict->alloc, dict->entries[index].hash),
+                    index);
+        dict->old_ctrl[i] = CTRL_DELETED;
+    }
+    dict->rehash_pos = end;
+    if (end == dict->old_alloc) {
+        free(dict->old_ctrl);
+        free(dict->old_slots);
+        dict->old_ctrl = NULL;
+        dict->old_slots = NULL;
+        dict->old_alloc = 0;
+        dict->rehash_pos = 0;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static bool _open_rehash(dict_f* dict, size_t new_alloc) {
+    // Only one resize is pending at a time
+    if (dict->old_alloc) _open_migrate(dict, SIZE_MAX);
+
+    uint8_t* old_ctrl = dict->ctrl;
+    size_t* old_slots = dict->slots;
+    const size_t old_alloc = dict->alloc;
+
+    if (!_open_alloc_table(dict, new_alloc)) {
+        dict->ctrl = old_ctrl;
+        dict->slots = old_slots;
+        return false;
+    }
+    if (dict->incremental) {
+        dict->old_ctrl = old_ctrl;
+        dict->old_slots = old_slots;
+        dict->old_alloc = old_alloc;
+        dict->rehash_pos = 0;
+        _open_migrate(dict, DICT_REHASH_STEP);
+        return true;
+    }
+
+    // The entries are dense, so a full rebuild is one sequential pass over
+    // them rather than a walk over the old slots
+    free(old_ctrl);
+    free(old_slots);
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        _open_place(dict, _open_free_slot(dict->ctrl, dict->alloc, dict->entries[i].hash), i);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static inline bool _open_needs_room(const dict_f* dict) {
+    // Keep live entries plus tombstones at or below 7/8 of the slots.
+    // Entries still in the old table are counted, so the new table always
+    // has room for them.
+    return (dict->hash_size + dict->tombstones + 1) * 8 > dict->alloc * 7;
+}
+// --------------------------------------------------------------------------------
+
+static bool _open_make_room(dict_f* dict) {
+    // When tombstones are what crowd the table, rebuilding at the same size
+    // is enough to clear them
+    if (!_open_needs_room(dict)) return true;
+    size_t new_alloc = dict->alloc;
+    if ((dict->hash_size + 1) * 16 > dict->alloc * 7) {
+        if (new_alloc > SIZE_MAX / 2 / sizeof(size_t)) {
+            errno = ENOMEM;
+            return false;
+        }
+        new_alloc *= 2;
+    }
+    return _open_rehash(dict, new_alloc);
+}
+// --------------------------------------------------------------------------------
+
+static size_t _open_find_or_insert(dict_f* dict, const hashed_key* key, float value,
+                                   bool* inserted) {
+    // One pass over the probe path finds the key or the slot it would take
+    size_t slot = SIZE_MAX;
+    size_t found = _open_probe(dict, dict->ctrl, dict->slots, dict->alloc, key, &slot);
+    if (found != SIZE_MAX) return dict->slots[found];
+    if (dict->old_alloc) {
+        found = _open_probe(dict, dict->old_ctrl, dict->old_slots, dict->old_alloc, key, NULL);
+        if (found != SIZE_MAX) return dict->old_slots[found];
+    }
+
+    // Only a resize moves the slot found above
+    if (_open_needs_room(dict) || slot == SIZE_MAX) {
+        if (!_open_make_room(dict)) return DICT_NONE;
+        slot = _open_free_slot(dict->ctrl, dict->alloc, key->hash);
+    }
+
+    const size_t index = _entries_push(dict, key, value);
+    if (index == DICT_NONE) return DICT_NONE;
+    _open_place(dict, slot, index);
+    dict->len++;
+    *inserted = true;
+    return index;
+}
+// --------------------------------------------------------------------------------
+
+static void _open_erase(dict_f* dict, size_t pos) {
+    // Frees the slot at pos.  The entry it referred to is removed separately.
+    const bool old = pos >= dict->alloc;
+    uint8_t* ctrl = old ? dict->old_ctrl : dict->ctrl;
+    const size_t slot = old ? pos - dict->alloc : pos;
+
+    // A probe never continues past a group with an EMPTY byte, so if this
+    // group already has one the slot can become EMPTY instead of a tombstone.
+    // The old table takes no inserts, so its tombstones are not counted.
+    const uint8_t* group = ctrl + (slot & ~(size_t)(DICT_GROUP - 1));
+    if (_group_match(group, CTRL_EMPTY)) {
+        ctrl[slot] = CTRL_EMPTY;
+    } else {
+        ctrl[slot] = CTRL_DELETED;
+        if (!old) dict->tombstones++;
+    }
+    dict->len--;
+}
+// ================================================================================
+// ================================================================================
+// CHAINED ENGINE
+//
+// Each bucket holds the index of its first entry and the entries of a bucket
+// are linked through fdictEntry.next.  While an incremental resize is pending,
+// a key belongs to its old bucket until that bucket has been migrated, so
+// every key is on exactly one chain.
 
-    // Tail
-    const unsigned char* tail = data + nblocks * 4;
-    uint32_t k1 = 0;
+static inline size_t* _chain_head(const dict_f* dict, size_t hash) {
+    if (dict->old_alloc) {
+        const size_t old_bucket = hash & (dict->old_alloc - 1);
+        if (old_bucket >= dict->rehash_pos) return &dict->old_heads[old_bucket];
+    }
+    return &dict->heads[hash & (dict->alloc - 1)];
+}
+// --------------------------------------------------------------------------------
 
-    switch (len & 3) {
-        case 3:
-            k1 ^= tail[2] << 16;
-            /* fallthrough */
-        case 2:
-            k1 ^= tail[1] << 8;
-            /* fallthrough */
-        case 1:
-            k1 ^= tail[0];
-            k1 *= c1;
-            k1 = (k1 << 15) | (k1 >> 17);  // ROTL32(k1, 15)
-            k1 *= c2;
-            h1 ^= k1;
+static size_t* _chain_alloc_heads(size_t alloc) {
+    size_t* heads = malloc(alloc * sizeof(size_t));
+    if (!heads) {
+        errno = ENOMEM;
+        return NULL;
     }
+    memset(heads, 0xFF, alloc * sizeof(size_t));  // Every bucket DICT_NONE
+    return heads;
+}
+// --------------------------------------------------------------------------------
 
-    // Finalization
-    h1 ^= len;
-    h1 ^= h1 >> 16;
-    h1 *= 0x85ebca6b;
-    h1 ^= h1 >> 13;
-    h1 *= 0xc2b2ae35;
-    h1 ^= h1 >> 16;
+static inline void _chain_link(dict_f* dict, size_t* head, size_t index) {
+    // Pushes entry index onto the front of a chain
+    if (*head == DICT_NONE) dict->len++;
+    dict->entries[index].next = *head;
+    *head = index;
+}
+// --------------------------------------------------------------------------------
 
-    return (size_t)h1;
+static void _chain_migrate(dict_f* dict, size_t count) {
+    // Moves the next count non-empty old buckets into the new table.  Runs of
+    // empty buckets are capped as well so one call stays short.
+    size_t empty_visits = count > SIZE_MAX / 10 ? SIZE_MAX : count * 10;
+    while (count && dict->rehash_pos < dict->old_alloc) {
+        size_t current = dict->old_heads[dict->rehash_pos];
+        dict->old_heads[dict->rehash_pos++] = DICT_NONE;
+        if (current == DICT_NONE) {
+            if (--empty_visits == 0) break;
+            continue;
+        }
+        dict->len--;  // The old bucket is now empty
+        while (current != DICT_NONE) {
+            size_t next = dict->entries[current].next;  // Save before relinking
+
+            // The cached hash gives the new bucket without reading the key
+            size_t new_index = dict->entries[current].hash & (dict->alloc - 1);
+            _chain_link(dict, &dict->heads[new_index], current);
+            current = next;
+        }
+        count--;
+    }
+    if (dict->rehash_pos == dict->old_alloc) {
+        free(dict->old_heads);
+        dict->old_heads = NULL;
+        dict->old_alloc = 0;
+        dict->rehash_pos = 0;
+    }
 }
 // --------------------------------------------------------------------------------
 
 /**
  * @brief Resizes the dictionary's hash table
- * 
+ *
+ * In incremental mode only the first few buckets move now; later mutations
+ * migrate the rest.
+ *
  * @param dict Pointer to the dictionary
  * @param new_size Desired new size for the hash table
  * @return bool true if resize successful, false otherwise
@@ -1025,68 +4923,303 @@ static bool resize_dict(dict_f* dict, size_t new_size) {
         return false;
     }
 
+    // Only one resize is pending at a time
+    if (dict->old_alloc) _chain_migrate(dict, SIZE_MAX);
+
     // Ensure new_size is a power of 2 for better distribution
     new_size = (size_t)pow(2, ceil(log2(new_size)));
 
-    // Use calloc for automatic zero initialization
-    fdictNode* new_table = calloc(new_size, sizeof(fdictNode));
-    if (!new_table) {
-        errno = ENOMEM;
-        return false;
+    size_t* new_heads = _chain_alloc_heads(new_size);
+    if (!new_heads) return false;
+
+    if (dict->incremental) {
+        // The current table is drained into the new one step by step
+        dict->old_heads = dict->heads;
+        dict->old_alloc = dict->alloc;
+        dict->rehash_pos = 0;
+        dict->heads = new_heads;
+        dict->alloc = new_size;
+        _chain_migrate(dict, DICT_REHASH_STEP);
+        return true;
     }
 
-    // Keep track of old table in case we need to recover
-    fdictNode* old_table = dict->keyValues;
-    const size_t old_size = dict->alloc;
-    size_t rehashed_count = 0;
+    // The entries are dense, so a full rebuild relinks them in one
+    // sequential pass
+    free(dict->heads);
+    dict->heads = new_heads;
+    dict->alloc = new_size;
+    dict->len = 0;
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        _chain_link(dict, &new_heads[dict->entries[i].hash & (new_size - 1)], i);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    // Rehash existing entries
-    for (size_t i = 0; i < old_size; i++) {
-        fdictNode* current = old_table[i].next;
-        
-        while (current) {
-            fdictNode* next = current->next;  // Save next pointer before modifying node
+static size_t _chain_find(const dict_f* dict, const hashed_key* key) {
+    for (size_t i = *_chain_head(dict, key->hash); i != DICT_NONE; i = dict->entries[i].next) {
+        const fdictEntry* entry = &dict->entries[i];
+        if (_key_equal(entry->key, entry->key_len, entry->hash, key)) return i;
+    }
+    return DICT_NONE;
+}
+// --------------------------------------------------------------------------------
 
-            // Calculate new index using enhanced hash function
-            size_t new_index = hash_function(current->key, HASH_SEED) % new_size;
+static size_t _chain_insert(dict_f* dict, const hashed_key* key, float value) {
+    // The caller has checked that key is absent, so the entry goes at the
+    // head of its chain without another walk
 
-            // Insert at the beginning of the new chain
-            current->next = new_table[new_index].next;
-            new_table[new_index].next = current;
-            
-            rehashed_count++;
-            current = next;
+    // Check load factor and resize if necessary using adaptive growth strategy
+    if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
+        size_t new_size;
+        if (dict->alloc < VEC_THRESHOLD) {
+            new_size = dict->alloc * 2;  // Double when small
+        } else {
+            new_size = dict->alloc + VEC_FIXED_AMOUNT;  // Linear growth when large
+        }
+
+        if (!resize_dict(dict, new_size)) {
+            return DICT_NONE;  // resize_dict sets appropriate errno
         }
     }
 
-    // Verify all entries were rehashed successfully
-    if (rehashed_count != dict->hash_size) {
-        // Cleanup and restore old state
-        for (size_t i = 0; i < new_size; i++) {
-            fdictNode* current = new_table[i].next;
-            while (current) {
-                fdictNode* next = current->next;
-                current->next = NULL;
-                current = next;
-            }
+    const size_t index = _entries_push(dict, key, value);
+    if (index == DICT_NONE) return DICT_NONE;
+    _chain_link(dict, _chain_head(dict, key->hash), index);
+    return index;
+}
+// --------------------------------------------------------------------------------
+
+static size_t _chain_unlink(dict_f* dict, const hashed_key* key) {
+    // Removes key from its chain and returns its entry index, or DICT_NONE
+    size_t* head = _chain_head(dict, key->hash);
+    for (size_t* link = head; *link != DICT_NONE; link = &dict->entries[*link].next) {
+        const size_t index = *link;
+        const fdictEntry* entry = &dict->entries[index];
+        if (_key_equal(entry->key, entry->key_len, entry->hash, key)) {
+            *link = entry->next;
+            if (*head == DICT_NONE) dict->len--;  // The bucket is now empty
+            return index;
         }
-        free(new_table);
-        errno = EAGAIN;
-        return false;
     }
+    return DICT_NONE;
+}
+// --------------------------------------------------------------------------------
 
-    // Update the dictionary only after successful rehashing
-    dict->keyValues = new_table;
-    dict->alloc = new_size;
+static size_t* _chain_ref(const dict_f* dict, size_t index) {
+    // The head or next field that refers to entry index
+    size_t* link = _chain_head(dict, dict->entries[index].hash);
+    while (*link != index) link = &dict->entries[*link].next;
+    return link;
+}
+// ================================================================================
+// ================================================================================
+// BACKEND INDEPENDENT DICTIONARY FUNCTIONS
 
-    // Clean up old table (but not the nodes, as they were moved)
-    free(old_table);
+static size_t _fdict_find(const dict_f* dict, const hashed_key* key) {
+    // Entry index of key, or DICT_NONE
+    if (dict->backend == DICT_OPEN) {
+        size_t pos = _open_find(dict, key);
+        return pos == SIZE_MAX ? DICT_NONE : *_open_slot(dict, pos);
+    }
+    return _chain_find(dict, key);
+}
+// --------------------------------------------------------------------------------
 
-    return true;
+static float* _fdict_lookup(const dict_f* dict, const char* key) {
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
+    size_t index = _fdict_find(dict, &hk);
+    return index == DICT_NONE ? NULL : &dict->values[index];
 }
 // --------------------------------------------------------------------------------
 
-dict_f* init_float_dict(void) {
+static bool _fdict_key_viewed(const dict_f* dict, const char* key) {
+    // True if key lives in the mapping of a loaded dictionary, not the arena
+    return dict->view && key >= (const char*)dict->view->base &&
+           key < (const char*)dict->view->base + dict->view->bytes;
+}
+// --------------------------------------------------------------------------------
+
+static void _fdict_remove_entry(dict_f* dict, size_t index) {
+    // Called once the table no longer refers to entry index.  The last entry
+    // moves into the hole so the entries stay dense, which changes only the
+    // one table reference to it.
+    if (!_fdict_key_viewed(dict, dict->entries[index].key)) {
+        _arena_free(&dict->arena, dict->entries[index].key, dict->entries[index].key_len + 1);
+    }
+    const size_t last = --dict->hash_size;
+    if (index == last) return;
+    if (dict->backend == DICT_OPEN) {
+        *_open_ref(dict, last) = index;
+    } else {
+        *_chain_ref(dict, last) = index;
+    }
+    dict->entries[index] = dict->entries[last];
+    dict->values[index] = dict->values[last];
+}
+// --------------------------------------------------------------------------------
+
+static void _fdict_drop_old(dict_f* dict) {
+    // Frees the old table of a pending resize.  Its entries stay in the
+    // entry array, so this is only called when that is reset as well.
+    free(dict->old_ctrl);
+    free(dict->old_slots);
+    free(dict->old_heads);
+    dict->old_ctrl = NULL;
+    dict->old_slots = NULL;
+    dict->old_heads = NULL;
+    dict->old_alloc = 0;
+    dict->rehash_pos = 0;
+}
+// --------------------------------------------------------------------------------
+
+static void _fdict_rehash_step(dict_f* dict) {
+    // Every mutation moves part of a pending resize forward
+    if (!dict->old_alloc) return;
+    if (dict->backend == DICT_OPEN) {
+        _open_migrate(dict, DICT_REHASH_STEP);
+    } else {
+        _chain_migrate(dict, DICT_REHASH_STEP);
+    }
+}
+// --------------------------------------------------------------------------------
+
+static float* _fdict_find_or_insert_hashed(dict_f* dict, const hashed_key* hk, float value,
+                                           bool* inserted) {
+    // Walks the key's probe path or chain once.  Returns the value slot of
+    // the existing entry, or of a new entry holding value.
+    _fdict_rehash_step(dict);
+    *inserted = false;
+    size_t index;
+    if (dict->backend == DICT_OPEN) {
+        index = _open_find_or_insert(dict, hk, value, inserted);
+    } else {
+        index = _chain_find(dict, hk);
+        if (index == DICT_NONE) {
+            index = _chain_insert(dict, hk, value);
+            *inserted = index != DICT_NONE;
+        }
+    }
+    return index == DICT_NONE ? NULL : &dict->values[index];
+}
+// --------------------------------------------------------------------------------
+
+static float* _fdict_find_or_insert(dict_f* dict, const char* key, float value,
+                                    bool* inserted) {
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
+    return _fdict_find_or_insert_hashed(dict, &hk, value, inserted);
+}
+// --------------------------------------------------------------------------------
+
+static inline void _fdict_prefetch(const dict_f* dict, size_t hash) {
+    // Starts loading the first group or bucket a key will probe
+    if (dict->backend == DICT_OPEN) {
+        size_t slot = _hash_group(hash, dict->alloc) * DICT_GROUP;
+        FLOAT_PREFETCH(dict->ctrl + slot);
+        FLOAT_PREFETCH(dict->slots + slot);
+    } else {
+        FLOAT_PREFETCH(dict->heads + (hash & (dict->alloc - 1)));
+    }
+}
+// --------------------------------------------------------------------------------
+
+static inline size_t _fdict_prefetch_entry(const dict_f* dict, size_t hash) {
+    // Second stage of a batched lookup.  Once the group or bucket prefetched
+    // by _fdict_prefetch has arrived, starts loading the first entry and
+    // value it points to.  Returns that entry's index, or DICT_NONE.
+    size_t index;
+    if (dict->backend == DICT_OPEN) {
+        const size_t slot = _hash_group(hash, dict->alloc) * DICT_GROUP;
+        const uint32_t match = _group_match(dict->ctrl + slot, _hash_tag(hash));
+        if (!match) return DICT_NONE;
+        index = dict->slots[slot + _ctz32(match)];
+    } else {
+        index = *_chain_head(dict, hash);
+        if (index == DICT_NONE) return DICT_NONE;
+    }
+    FLOAT_PREFETCH(dict->entries + index);
+    FLOAT_PREFETCH(dict->values + index);
+    return index;
+}
+// --------------------------------------------------------------------------------
+
+static size_t _fdict_alloc_for(const dict_f* dict, size_t capacity) {
+    // Smallest power-of-two table that holds capacity entries without
+    // growing, or 0 if that size cannot be represented
+    size_t need;
+    if (dict->backend == DICT_OPEN) {
+        if (capacity > SIZE_MAX / 8 / sizeof(size_t)) return 0;
+        need = (capacity * 8 + 6) / 7;
+    } else {
+        if (capacity > SIZE_MAX / 2 / sizeof(size_t)) return 0;
+        need = (size_t)((double)capacity / LOAD_FACTOR_THRESHOLD) + 1;
+    }
+    size_t alloc = hashSize;
+    while (alloc < need) alloc *= 2;
+    return alloc;
+}
+// --------------------------------------------------------------------------------
+
+static void* _fdict_dup(const void* src, size_t size) {
+    void* copy = malloc(size);
+    if (!copy) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memcpy(copy, src, size);
+    return copy;
+}
+// --------------------------------------------------------------------------------
+
+static void _fdict_rebuild(dict_f* dict) {
+    // Places every entry in the current table again by its cached hash.  Any
+    // pending resize is dropped, since the entry array holds all entries.
+    _fdict_drop_old(dict);
+    if (dict->backend == DICT_OPEN) {
+        memset(dict->ctrl, CTRL_EMPTY, dict->alloc);
+        dict->tombstones = 0;
+        for (size_t i = 0; i < dict->hash_size; i++) {
+            _open_place(dict, _open_free_slot(dict->ctrl, dict->alloc, dict->entries[i].hash), i);
+        }
+    } else {
+        memset(dict->heads, 0xFF, dict->alloc * sizeof(size_t));
+        dict->len = 0;
+        for (size_t i = 0; i < dict->hash_size; i++) {
+            _chain_link(dict, &dict->heads[dict->entries[i].hash & (dict->alloc - 1)], i);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+static void _fdict_release(dict_f* dict) {
+    // Frees every entry and the table, leaving the struct itself
+    _fdict_drop_old(dict);
+    _arena_release(&dict->arena);
+    free(dict->ctrl);
+    free(dict->slots);
+    free(dict->heads);
+    free(dict->entries);
+    if (!dict->view_values) free(dict->values);
+#if defined(C_FLOAT_MMAP)
+    if (dict->view) _file_release(dict->view);
+#endif
+    dict->view = NULL;
+    dict->view_values = false;
+    dict->ctrl = NULL;
+    dict->slots = NULL;
+    dict->heads = NULL;
+    dict->entries = NULL;
+    dict->values = NULL;
+    dict->entry_alloc = 0;
+}
+// --------------------------------------------------------------------------------
+
+dict_f* init_float_dict_ex(dict_backend backend) {
+    if (backend != DICT_OPEN && backend != DICT_CHAINED) {
+        errno = EINVAL;
+        return NULL;
+    }
+
     // Allocate the dictionary structure
     dict_f* dict = calloc(1, sizeof(dict_f));
     if (!dict) {
@@ -1094,114 +5227,251 @@ dict_f* init_float_dict(void) {
         fprintf(stderr, "Failed to allocate dictionary structure\n");
         return NULL;
     }
+    dict->backend = backend;
+    dict->hash_fn = c_float_hash_wy;
+    dict->seed = _dict_seed(dict);
 
-    // Allocate initial hash table array
-    dict->keyValues = calloc(hashSize, sizeof(fdictNode));
-    if (!dict->keyValues) {
-        errno = ENOMEM;
+    // Allocate the entry arrays and the initial hash table
+    bool ok = _entries_reserve(dict, hashSize);
+    if (ok && backend == DICT_OPEN) {
+        ok = _open_alloc_table(dict, hashSize);
+    } else if (ok) {
+        dict->heads = _chain_alloc_heads(hashSize);
+        dict->alloc = hashSize;
+        ok = dict->heads != NULL;
+    }
+    if (!ok) {
         fprintf(stderr, "Failed to allocate hash table array\n");
-        free(dict);
+        free_float_dict(dict);
+        errno = ENOMEM;
         return NULL;
     }
 
     // Initialize dictionary metadata
     dict->hash_size = 0;   // No items yet
     dict->len = 0;         // No occupied buckets
-    dict->alloc = hashSize;
 
     return dict;
 }
 // --------------------------------------------------------------------------------
 
-bool insert_float_dict(dict_f* dict, const char* key, float value) {
-    if (!dict || !key) {
+dict_f* init_float_dict(void) {
+    return init_float_dict_ex(DICT_OPEN);
+}
+// --------------------------------------------------------------------------------
+
+dict_backend float_dict_backend(const dict_f* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return DICT_OPEN;
+    }
+    return dict->backend;
+}
+// --------------------------------------------------------------------------------
+
+bool set_float_dict_hash(dict_f* dict, dict_hash_fn hash, uint64_t seed) {
+    if (!dict || !hash) {
         errno = EINVAL;
         return false;
     }
+    dict->hash_fn = hash;
+    dict->seed = seed;
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        fdictEntry* entry = &dict->entries[i];
+        entry->hash = hash(entry->key, entry->key_len, seed);
+    }
+    _fdict_rebuild(dict);
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    // Check load factor and resize if necessary using adaptive growth strategy
-    if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
-        size_t new_size;
-        if (dict->alloc < VEC_THRESHOLD) {
-            new_size = dict->alloc * 2;  // Double when small
+uint64_t float_dict_seed(const dict_f* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return 0;
+    }
+    return dict->seed;
+}
+// --------------------------------------------------------------------------------
+
+bool set_float_dict_incremental(dict_f* dict, bool incremental) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    // Leaving incremental mode finishes any pending resize
+    if (!incremental && dict->old_alloc) {
+        if (dict->backend == DICT_OPEN) {
+            _open_migrate(dict, SIZE_MAX);
         } else {
-            new_size = dict->alloc + VEC_FIXED_AMOUNT;  // Linear growth when large
-        }
-        
-        if (!resize_dict(dict, new_size)) {
-            return false;  // resize_dict sets appropriate errno
+            _chain_migrate(dict, SIZE_MAX);
         }
     }
+    dict->incremental = incremental;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool is_float_dict_rehashing(const dict_f* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    return dict->old_alloc != 0;
+}
+// --------------------------------------------------------------------------------
 
-    // Rest of the function remains the same as previous improvement...
-    const size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    // Check for existing key
-    for (fdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            errno = EEXIST;
-            return false;
-        }
+dict_f* init_float_dict_with_capacity(size_t capacity) {
+    dict_f* dict = init_float_dict_ex(DICT_OPEN);
+    if (!dict) return NULL;
+    if (!reserve_float_dict(dict, capacity)) {
+        free_float_dict(dict);
+        return NULL;  // errno set by reserve_float_dict
     }
+    return dict;
+}
+// --------------------------------------------------------------------------------
 
-    char* new_key = strdup(key);
-    if (!new_key) {
+bool reserve_float_dict(dict_f* dict, size_t capacity) {
+    if (!dict) {
+        errno = EINVAL;
+        return false;
+    }
+    const size_t alloc = _fdict_alloc_for(dict, capacity);
+    if (alloc == 0) {
         errno = ENOMEM;
         return false;
     }
+    if (!_entries_reserve(dict, capacity)) return false;
+    if (alloc <= dict->alloc) return true;  // Never shrinks
 
-    fdictNode* new_node = malloc(sizeof(fdictNode));
-    if (!new_node) {
-        free(new_key);
+    // Follows the dictionary's resize mode like any other growth
+    if (dict->backend == DICT_OPEN) return _open_rehash(dict, alloc);
+    return resize_dict(dict, alloc);
+}
+// --------------------------------------------------------------------------------
+size_t insert_many_float_dict(dict_f* dict, const char* const keys[], const float values[],
+                              size_t n) {
+    if (!dict || (n && (!keys || !values))) {
+        errno = EINVAL;
+        return SIZE_MAX;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i]) {
+            errno = EINVAL;
+            return SIZE_MAX;
+        }
+    }
+
+    // One resize up front instead of log2(n) along the way
+    if (n > SIZE_MAX - dict->hash_size || !reserve_float_dict(dict, dict->hash_size + n)) {
         errno = ENOMEM;
+        return SIZE_MAX;
+    }
+
+    // Keys are hashed a batch at a time and the first group or bucket of
+    // each is prefetched, so the cache misses of a batch overlap instead of
+    // being paid one insert after another
+    size_t inserted_count = 0;
+    hashed_key batch[SEARCH_BATCH];
+    for (size_t start = 0; start < n; start += SEARCH_BATCH) {
+        const size_t count = n - start < SEARCH_BATCH ? n - start : SEARCH_BATCH;
+        for (size_t j = 0; j < count; j++) {
+            batch[j] = _hash_key(keys[start + j], dict->hash_fn, dict->seed);
+            _fdict_prefetch(dict, batch[j].hash);
+        }
+        for (size_t j = 0; j < count; j++) {
+            bool inserted;
+            if (!_fdict_find_or_insert_hashed(dict, &batch[j], values[start + j], &inserted)) {
+                return SIZE_MAX;  // errno set by the allocator
+            }
+            inserted_count += inserted;
+        }
+    }
+    return inserted_count;
+}
+// --------------------------------------------------------------------------------
+
+bool insert_float_dict(dict_f* dict, const char* key, float value) {
+    if (!dict || !key) {
+        errno = EINVAL;
         return false;
     }
 
-    new_node->key = new_key;
-    new_node->value = value;
-    new_node->next = dict->keyValues[index].next;
-    dict->keyValues[index].next = new_node;
+    bool inserted;
+    if (!_fdict_find_or_insert(dict, key, value, &inserted)) {
+        return false;  // errno set by the allocator
+    }
+    if (!inserted) {
+        errno = EEXIST;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    dict->hash_size++;
-    if (new_node->next == NULL) {
-        dict->len++;
+bool upsert_float_dict(dict_f* dict, const char* key, float value) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return false;
+    }
+
+    bool inserted;
+    float* slot = _fdict_find_or_insert(dict, key, value, &inserted);
+    if (!slot) return false;
+    *slot = value;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool add_to_float_dict(dict_f* dict, const char* key, float delta) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return false;
     }
 
+    // A missing key starts from zero, so it is inserted holding delta
+    bool inserted;
+    float* slot = _fdict_find_or_insert(dict, key, delta, &inserted);
+    if (!slot) return false;
+    if (!inserted) *slot += delta;
     return true;
 }
 // --------------------------------------------------------------------------------
 
+float* get_or_insert_float_dict(dict_f* dict, const char* key, float value) {
+    if (!dict || !key) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    bool inserted;
+    return _fdict_find_or_insert(dict, key, value, &inserted);
+}
+// --------------------------------------------------------------------------------
+
 float pop_float_dict(dict_f* dict, const char* key) {
     if (!dict || !key) {
         errno = EINVAL;
         return FLT_MAX;
     }
 
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    fdictNode* prev = &dict->keyValues[index];
-    fdictNode* current = prev->next;
-    
-    while (current) {
-        if (strcmp(current->key, key) == 0) {
-            // Save value and unlink node
-            float value = current->value;
-            prev->next = current->next;
-            
-            // Update dictionary metadata
-            dict->hash_size--;
-            if (!prev->next) {  // If bucket is now empty
-                dict->len--;
-            }
-            
-            // Clean up node memory
-            free(current->key);
-            free(current);
-            
-            return value;
+    _fdict_rehash_step(dict);
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
+    size_t index = DICT_NONE;
+    if (dict->backend == DICT_OPEN) {
+        size_t pos = _open_find(dict, &hk);
+        if (pos != SIZE_MAX) {
+            index = *_open_slot(dict, pos);
+            _open_erase(dict, pos);
         }
-        prev = current;
-        current = current->next;
+    } else {
+        index = _chain_unlink(dict, &hk);
+    }
+    if (index != DICT_NONE) {
+        float value = dict->values[index];
+        _fdict_remove_entry(dict, index);
+        return value;
     }
 
     errno = ENOENT;  // Set errno when key not found
@@ -1215,40 +5485,67 @@ float get_float_dict_value(const dict_f* dict, const char* key) {
         return FLT_MAX;
     }
 
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    for (const fdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            return current->value;
-        }
-    }
+    const float* value = _fdict_lookup(dict, key);
+    if (value) return *value;
 
     errno = ENOENT;  // Set errno when key not found
     return FLT_MAX;
 }
 // --------------------------------------------------------------------------------
 
-void free_float_dict(dict_f* dict) {
-    if (!dict) {
-        return;  // Silent return on NULL - common pattern for free functions
+size_t get_many_float_dict(const dict_f* dict, const char* const keys[], size_t n,
+                           float out_values[], bool out_found[]) {
+    if (!dict || (n && (!keys || !out_values))) {
+        errno = EINVAL;
+        return SIZE_MAX;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i]) {
+            errno = EINVAL;
+            return SIZE_MAX;
+        }
     }
 
-    // Free all nodes in each bucket
-    for (size_t i = 0; i < dict->alloc; i++) {
-        fdictNode* current = dict->keyValues[i].next;
-        while (current) {      
-            fdictNode* next = current->next;  // Save next pointer before freeing
-            free(current->key);
-            free(current);
-            current = next;
+    // Each batch runs as a pipeline of passes, each of which starts the
+    // loads the next one needs: the query strings, then the group or bucket
+    // of every key, then the entry each one points to, then that entry's
+    // stored key.  The last pass resolves the keys.  The cache misses of a
+    // batch overlap instead of being paid one lookup after another.
+    size_t found_count = 0;
+    hashed_key batch[SEARCH_BATCH];
+    size_t first[SEARCH_BATCH];
+    for (size_t start = 0; start < n; start += SEARCH_BATCH) {
+        const size_t count = n - start < SEARCH_BATCH ? n - start : SEARCH_BATCH;
+        for (size_t j = 0; j < count; j++) FLOAT_PREFETCH(keys[start + j]);
+        for (size_t j = 0; j < count; j++) {
+            batch[j] = _hash_key(keys[start + j], dict->hash_fn, dict->seed);
+            _fdict_prefetch(dict, batch[j].hash);
+        }
+        for (size_t j = 0; j < count; j++) first[j] = _fdict_prefetch_entry(dict, batch[j].hash);
+        for (size_t j = 0; j < count; j++) {
+            if (first[j] != DICT_NONE) FLOAT_PREFETCH(dict->entries[first[j]].key);
+        }
+        for (size_t j = 0; j < count; j++) {
+            const size_t index = _fdict_find(dict, &batch[j]);
+            const bool found = index != DICT_NONE;
+            out_values[start + j] = found ? dict->values[index] : FLT_MAX;
+            if (out_found) out_found[start + j] = found;
+            found_count += found;
         }
     }
+    return found_count;
+}
+// --------------------------------------------------------------------------------
 
-    // Free the hash table and dictionary struct
-    free(dict->keyValues);
+void free_float_dict(dict_f* dict) {
+    if (!dict) {
+        return;  // Silent return on NULL - common pattern for free functions
+    }
+
+    _fdict_release(dict);
     free(dict);
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
 void _free_float_dict(dict_f** dict_ptr) {
     if (dict_ptr && *dict_ptr) {
@@ -1264,13 +5561,11 @@ bool update_float_dict(dict_f* dict, const char* key, float value) {
         return false;
     }
 
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    for (fdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            current->value = value;
-            return true;
-        }
+    _fdict_rehash_step(dict);
+    float* slot = _fdict_lookup(dict, key);
+    if (slot) {
+        *slot = value;
+        return true;
     }
 
     errno = ENOENT;  // More specific error code for missing key
@@ -1303,7 +5598,7 @@ size_t float_dict_hash_size(const dict_f* dict) {
     }
     return dict->hash_size;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
 bool has_key_float_dict(const dict_f* dict, const char* key) {
     if (!dict || !key) {
@@ -1311,17 +5606,9 @@ bool has_key_float_dict(const dict_f* dict, const char* key) {
         return false;
     }
 
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-
-    for (const fdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            return true;
-        }
-    }
-
-    return false;
+    return _fdict_lookup(dict, key) != NULL;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
 dict_f* copy_float_dict(const dict_f* dict) {
     if (!dict) {
@@ -1329,41 +5616,65 @@ dict_f* copy_float_dict(const dict_f* dict) {
         return NULL;
     }
 
-    // Create new dictionary with same capacity
-    dict_f* new_dict = malloc(sizeof(dict_f));
+    dict_f* new_dict = calloc(1, sizeof(dict_f));
     if (!new_dict) {
         errno = ENOMEM;
         return NULL;
     }
 
-    new_dict->keyValues = calloc(dict->alloc, sizeof(fdictNode));
-    if (!new_dict->keyValues) {
-        free(new_dict);
-        errno = ENOMEM;
-        return NULL;
-    }
-
-    // Copy metadata
+    // The copy keeps the source's table sizes, entry order and any pending
+    // incremental resize, so no key is hashed, compared or checked for
+    // duplicates.  The entries, values and tables are copied whole and every
+    // key comes from one slab.
+    new_dict->backend = dict->backend;
+    new_dict->hash_fn = dict->hash_fn;
+    new_dict->seed = dict->seed;
+    new_dict->hash_size = dict->hash_size;
+    new_dict->len = dict->len;
     new_dict->alloc = dict->alloc;
-    new_dict->hash_size = 0;  // Will be incremented during insertion
-    new_dict->len = 0;        // Will be incremented during insertion
-
-    // Copy all entries
-    for (size_t i = 0; i < dict->alloc; i++) {
-        fdictNode* current = dict->keyValues[i].next;
-        while (current) {
-            // Insert will handle incrementing hash_size and len
-            if (!insert_float_dict(new_dict, current->key, current->value)) {
-                free_float_dict(new_dict);  // Clean up on failure
-                return NULL;
-            }
-            current = current->next;
+    new_dict->tombstones = dict->tombstones;
+    new_dict->incremental = dict->incremental;
+    new_dict->old_alloc = dict->old_alloc;
+    new_dict->rehash_pos = dict->rehash_pos;
+
+    bool ok = _entries_reserve(new_dict, dict->entry_alloc) &&
+              _arena_reserve(&new_dict->arena, dict->arena.live_bytes);
+    if (ok) {
+        memcpy(new_dict->entries, dict->entries, dict->hash_size * sizeof(fdictEntry));
+        memcpy(new_dict->values, dict->values, dict->hash_size * sizeof(float));
+        for (size_t i = 0; ok && i < dict->hash_size; i++) {
+            fdictEntry* entry = &new_dict->entries[i];
+            char* key = _arena_alloc(&new_dict->arena, entry->key_len + 1);
+            if (key) memcpy(key, entry->key, entry->key_len + 1);
+            entry->key = key;
+            ok = key != NULL;
+        }
+    }
+    if (ok && dict->backend == DICT_OPEN) {
+        new_dict->ctrl = _fdict_dup(dict->ctrl, dict->alloc);
+        new_dict->slots = _fdict_dup(dict->slots, dict->alloc * sizeof(size_t));
+        ok = new_dict->ctrl && new_dict->slots;
+        if (ok && dict->old_alloc) {
+            new_dict->old_ctrl = _fdict_dup(dict->old_ctrl, dict->old_alloc);
+            new_dict->old_slots = _fdict_dup(dict->old_slots, dict->old_alloc * sizeof(size_t));
+            ok = new_dict->old_ctrl && new_dict->old_slots;
+        }
+    } else if (ok) {
+        new_dict->heads = _fdict_dup(dict->heads, dict->alloc * sizeof(size_t));
+        ok = new_dict->heads != NULL;
+        if (ok && dict->old_alloc) {
+            new_dict->old_heads = _fdict_dup(dict->old_heads, dict->old_alloc * sizeof(size_t));
+            ok = new_dict->old_heads != NULL;
         }
     }
+    if (!ok) {
+        free_float_dict(new_dict);  // Clean up on failure
+        return NULL;
+    }
 
     return new_dict;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
 bool clear_float_dict(dict_f* dict) {
     if (!dict) {
@@ -1371,16 +5682,15 @@ bool clear_float_dict(dict_f* dict) {
         return false;
     }
 
-    // Free all nodes in each bucket
-    for (size_t i = 0; i < dict->alloc; i++) {
-        fdictNode* current = dict->keyValues[i].next;
-        while (current) {
-            fdictNode* next = current->next;
-            free(current->key);
-            free(current);
-            current = next;
-        }
-        dict->keyValues[i].next = NULL;  // Reset bucket head
+    // Keys live in the arena and the entry array keeps its capacity, so
+    // only the table has to be reset
+    _fdict_drop_old(dict);
+    _arena_release(&dict->arena);
+    if (dict->backend == DICT_OPEN) {
+        memset(dict->ctrl, CTRL_EMPTY, dict->alloc);
+        dict->tombstones = 0;
+    } else {
+        memset(dict->heads, 0xFF, dict->alloc * sizeof(size_t));
     }
 
     // Reset dictionary metadata
@@ -1389,7 +5699,7 @@ bool clear_float_dict(dict_f* dict) {
 
     return true;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
 string_v* get_keys_float_dict(const dict_f* dict) {
     if (!dict) {
@@ -1401,18 +5711,16 @@ string_v* get_keys_float_dict(const dict_f* dict) {
         errno = ENOMEM;
         return NULL;
     }
-    for (size_t i = 0; i < dict->alloc; i++) {
-        for (fdictNode* current = dict->keyValues[i].next; current; current = current->next) {
-            if (!push_back_str_vector(vec, current->key)) {
-                free_str_vector(vec);
-                errno = ENOMEM;
-                return NULL;
-            }
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        if (!push_back_str_vector(vec, dict->entries[i].key)) {
+            free_str_vector(vec);
+            errno = ENOMEM;
+            return NULL;
         }
     }
     return vec;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
 float_v* get_values_float_dict(const dict_f* dict) {
     if (!dict) {
@@ -1424,19 +5732,13 @@ float_v* get_values_float_dict(const dict_f* dict) {
         errno = ENOMEM;
         return NULL;
     }
-    // Iterate through all buckets
-    for (size_t i = 0; i < dict->alloc; i++) {
-        for (fdictNode* current = dict->keyValues[i].next; current; current = current->next) {
-            if (!push_back_float_vector(vec, current->value)) {
-                free_float_vector(vec);
-                errno = ENOMEM;
-                return NULL;
-            }
-        }
-    }
+    // The values are already contiguous, so they are copied in one block
+    memcpy(vec->data, dict->values, dict->hash_size * sizeof(float));
+    vec->len = dict->hash_size;
+    vec->sorted = vec->len <= 1;
     return vec;
 }
-// -------------------------------------------------------------------------------- 
+// --------------------------------------------------------------------------------
 
 dict_f* merge_float_dict(const dict_f* dict1, const dict_f* dict2, bool overwrite) {
     if (!dict1 || !dict2) {
@@ -1445,44 +5747,37 @@ dict_f* merge_float_dict(const dict_f* dict1, const dict_f* dict2, bool overwrit
     }
 
     // Create new dictionary with capacity for all items
-    //size_t initial_size = dict1->hash_size + dict2->hash_size;
-    dict_f* merged = init_float_dict();
+    size_t initial_size = dict1->hash_size + dict2->hash_size;
+    dict_f* merged = init_float_dict_ex(dict1->backend);
     if (!merged) {
         return NULL;  // errno set by init_float_dict
     }
+    if (!reserve_float_dict(merged, initial_size)) {
+        free_float_dict(merged);
+        return NULL;
+    }
+    merged->incremental = dict1->incremental;
+    merged->hash_fn = dict1->hash_fn;  // The seed stays the merged dictionary's own
 
     // First, copy all entries from dict1
-    for (size_t i = 0; i < dict1->alloc; i++) {
-        for (fdictNode* current = dict1->keyValues[i].next; current; current = current->next) {
-            if (!insert_float_dict(merged, current->key, current->value)) {
-                free_float_dict(merged);
-                return NULL;
-            }
+    for (size_t i = 0; i < dict1->hash_size; i++) {
+        if (!insert_float_dict(merged, dict1->entries[i].key, dict1->values[i])) {
+            free_float_dict(merged);
+            return NULL;
         }
     }
 
-    // Then handle dict2 entries
-    for (size_t i = 0; i < dict2->alloc; i++) {
-        for (fdictNode* current = dict2->keyValues[i].next; current; current = current->next) {
-            float existing_value;
-            // Check if key exists in merged dictionary
-            if ((existing_value = get_float_dict_value(merged, current->key)) != FLT_MAX) {
-                if (overwrite) {
-                    // Update existing value if overwrite is true
-                    if (!update_float_dict(merged, current->key, current->value)) {
-                        free_float_dict(merged);
-                        return NULL;
-                    }
-                }
-                // If overwrite is false, keep original value
-            } else {
-                // Key doesn't exist, insert new entry
-                if (!insert_float_dict(merged, current->key, current->value)) {
-                    free_float_dict(merged);
-                    return NULL;
-                }
-            }
+    // Then handle dict2 entries with one probe each.  A missing key is
+    // inserted; an existing one keeps its value unless overwrite is true.
+    for (size_t i = 0; i < dict2->hash_size; i++) {
+        bool inserted;
+        const float value = dict2->values[i];
+        float* slot = _fdict_find_or_insert(merged, dict2->entries[i].key, value, &inserted);
+        if (!slot) {
+            free_float_dict(merged);
+            return NULL;
         }
+        if (overwrite) *slot = value;
     }
 
     return merged;
@@ -1495,19 +5790,56 @@ bool foreach_float_dict(const dict_f* dict, dict_iterator iter, void* user_data)
         return false;
     }
 
-    for (size_t i = 0; i < dict->alloc; i++) {
-        for (fdictNode* current = dict->keyValues[i].next; current; current = current->next) {
-            iter(current->key, current->value, user_data);
-        }
+    // Entries are dense, so this is a linear scan in insertion order
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        iter(dict->entries[i].key, dict->values[i], user_data);
     }
 
     return true;
 }
+// --------------------------------------------------------------------------------
+
+const float* float_dict_values(const dict_f* dict) {
+    if (!dict) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return dict->values;
+}
+// --------------------------------------------------------------------------------
+
+float sum_float_dict(const dict_f* dict) {
+    if (!dict || dict->hash_size == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _sum_range(dict->values, dict->hash_size, SUM_PAIRWISE);
+}
+// --------------------------------------------------------------------------------
+
+float min_float_dict(const dict_f* dict) {
+    if (!dict || dict->hash_size == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _simd()->min(dict->values, dict->hash_size);
+}
+// --------------------------------------------------------------------------------
+
+float max_float_dict(const dict_f* dict) {
+    if (!dict || dict->hash_size == 0) {
+        errno = EINVAL;
+        return FLT_MAX;
+    }
+    return _simd()->max(dict->values, dict->hash_size);
+}
 // ================================================================================ 
 // ================================================================================
 
 typedef struct fvdictNode {
     char* key;
+    size_t key_len;  // Cached so lookups compare lengths before bytes
+    size_t hash;     // Cached so resizing never hashes a key again
     float_v* value;
     struct fvdictNode* next;
 } fvdictNode;
@@ -1518,18 +5850,24 @@ struct dict_fv {
     size_t hash_size;
     size_t len;
     size_t alloc;
+    dict_hash_fn hash_fn;
+    uint64_t seed;
+    dict_arena arena;  // Chain nodes and keys
 };
 // --------------------------------------------------------------------------------
 
 dict_fv* init_floatv_dict(void) {
     // Allocate the dictionary structure
-    dict_fv* dict = calloc(1, sizeof(dict_f));
+    dict_fv* dict = calloc(1, sizeof(dict_fv));
     if (!dict) {
         errno = ENOMEM;
         fprintf(stderr, "Failed to allocate vector dictionary structure\n");
         return NULL;
     }
 
+    dict->hash_fn = c_float_hash_wy;
+    dict->seed = _dict_seed(dict);
+
     // Allocate initial hash table array
     dict->keyValues = calloc(hashSize, sizeof(fvdictNode));
     if (!dict->keyValues) {
@@ -1569,6 +5907,7 @@ static bool resize_dictv(dict_fv* dict, size_t new_size) {
     fvdictNode* old_table = dict->keyValues;
     const size_t old_size = dict->alloc;
     size_t rehashed_count = 0;
+    size_t occupied = 0;
 
     // Rehash all existing entries into the new table
     for (size_t i = 0; i < old_size; ++i) {
@@ -1576,9 +5915,10 @@ static bool resize_dictv(dict_fv* dict, size_t new_size) {
         while (current) {
             fvdictNode* next = current->next;
 
-            size_t new_index = hash_function(current->key, HASH_SEED) % new_size;
+            size_t new_index = current->hash & (new_size - 1);
 
             // Reinsert into the new hash bucket (head insertion)
+            if (!new_table[new_index].next) occupied++;
             current->next = new_table[new_index].next;
             new_table[new_index].next = current;
 
@@ -1606,6 +5946,7 @@ static bool resize_dictv(dict_fv* dict, size_t new_size) {
     // Replace table on success
     dict->keyValues = new_table;
     dict->alloc = new_size;
+    dict->len = occupied;
 
     // Free old hash bucket array (nodes were moved, not freed)
     free(old_table);
@@ -1614,12 +5955,16 @@ static bool resize_dictv(dict_fv* dict, size_t new_size) {
 }
 // --------------------------------------------------------------------------------
 
-bool create_floatv_dict(dict_fv* dict, char* key, size_t size) {
-    if (!dict || !key) {
-        errno = EINVAL;
-        return false;
+static fvdictNode* _fvdict_find(const dict_fv* dict, const hashed_key* key) {
+    for (fvdictNode* current = dict->keyValues[key->hash & (dict->alloc - 1)].next; current;
+         current = current->next) {
+        if (_key_equal(current->key, current->key_len, current->hash, key)) return current;
     }
+    return NULL;
+}
+// --------------------------------------------------------------------------------
 
+static bool _fvdict_insert(dict_fv* dict, const hashed_key* key, float_v* value) {
     // Resize if load factor exceeded
     if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
         size_t new_size = (dict->alloc < VEC_THRESHOLD)
@@ -1631,48 +5976,92 @@ bool create_floatv_dict(dict_fv* dict, char* key, size_t size) {
         }
     }
 
-    const size_t index = hash_function(key, HASH_SEED) % dict->alloc;
+    // Allocate key and node from the dictionary's arena
+    char* new_key = _key_copy(&dict->arena, key);
+    if (!new_key) return false;
 
-    // Check for key collision
-    for (fvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            errno = EEXIST;
-            return false;
+    fvdictNode* new_node = _arena_alloc(&dict->arena, sizeof(fvdictNode));
+    if (!new_node) {
+        _arena_free(&dict->arena, new_key, key->len + 1);
+        return false;
+    }
+
+    const size_t index = key->hash & (dict->alloc - 1);
+    new_node->key = new_key;
+    new_node->key_len = key->len;
+    new_node->hash = key->hash;
+    new_node->value = value;
+    new_node->next = dict->keyValues[index].next;
+    dict->keyValues[index].next = new_node;
+
+    dict->hash_size++;
+    if (new_node->next == NULL) {
+        dict->len++;
+    }
+
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool set_floatv_dict_hash(dict_fv* dict, dict_hash_fn hash, uint64_t seed) {
+    if (!dict || !hash) {
+        errno = EINVAL;
+        return false;
+    }
+    dict->hash_fn = hash;
+    dict->seed = seed;
+
+    // Detach every chain into one list, then link each node back in under
+    // its new hash.  Nodes are reused, so nothing is allocated.
+    fvdictNode* pending = NULL;
+    for (size_t i = 0; i < dict->alloc; i++) {
+        fvdictNode* current = dict->keyValues[i].next;
+        dict->keyValues[i].next = NULL;
+        while (current) {
+            fvdictNode* next = current->next;
+            current->next = pending;
+            pending = current;
+            current = next;
         }
     }
+    dict->len = 0;
+    while (pending) {
+        fvdictNode* next = pending->next;
+        pending->hash = hash(pending->key, pending->key_len, seed);
+        fvdictNode* bucket = &dict->keyValues[pending->hash & (dict->alloc - 1)];
+        if (!bucket->next) dict->len++;
+        pending->next = bucket->next;
+        bucket->next = pending;
+        pending = next;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
 
-    char* new_key = strdup(key);
-    if (!new_key) {
-        errno = ENOMEM;
+bool create_floatv_dict(dict_fv* dict, char* key, size_t size) {
+    if (!dict || !key) {
+        errno = EINVAL;
         return false;
     }
 
-    fvdictNode* new_node = malloc(sizeof(fvdictNode));
-    if (!new_node) {
-        free(new_key);
-        errno = ENOMEM;
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
+
+    // Check for key collision
+    if (_fvdict_find(dict, &hk)) {
+        errno = EEXIST;
         return false;
     }
 
-    float_v* value = NULL;
-    value = init_float_vector(size);
+    float_v* value = init_float_vector(size);
     if (!value) {
-        free(new_key);
-        free(new_node);
         errno = ENOMEM;
         return false;
     }
 
-    new_node->key = new_key;
-    new_node->value = value;
-    new_node->next = dict->keyValues[index].next;
-    dict->keyValues[index].next = new_node;
-
-    dict->hash_size++;
-    if (new_node->next == NULL) {
-        dict->len++;
+    if (!_fvdict_insert(dict, &hk, value)) {
+        free_float_vector(value);
+        return false;
     }
-
     return true;
 }
 // --------------------------------------------------------------------------------
@@ -1683,25 +6072,25 @@ bool pop_floatv_dict(dict_fv* dict, const char* key) {
         return false;
     }
 
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    fvdictNode* prev = &dict->keyValues[index];
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
+    fvdictNode* bucket = &dict->keyValues[hk.hash & (dict->alloc - 1)];
+    fvdictNode* prev = bucket;
     fvdictNode* current = prev->next;
     
     while (current) {
-        if (strcmp(current->key, key) == 0) {
+        if (_key_equal(current->key, current->key_len, current->hash, &hk)) {
             prev->next = current->next;
             
             // Update dictionary metadata
             dict->hash_size--;
-            if (!prev->next) {  // If bucket is now empty
+            if (!bucket->next) {  // If bucket is now empty
                 dict->len--;
             }
             
-            // Clean up node memory
+            // Clean up the vector and return node memory to the arena
             free_float_vector(current->value);
-            free(current->key);
-            free(current);
+            _arena_free(&dict->arena, current->key, current->key_len + 1);
+            _arena_free(&dict->arena, current, sizeof(fvdictNode));
             
             return true;
         }
@@ -1720,12 +6109,10 @@ float_v* return_floatv_pointer(dict_fv* dict, const char* key) {
         return NULL;
     }
 
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-    
-    for (const fvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            return current->value;
-        }
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
+    const fvdictNode* node = _fvdict_find(dict, &hk);
+    if (node) {
+        return node->value;
     }
 
     errno = ENOENT;  // Set errno when key not found
@@ -1738,21 +6125,15 @@ void free_floatv_dict(dict_fv* dict) {
         return;  // Silent return on NULL - common pattern for free functions
     }
 
-    // Free all nodes in each bucket
+    // The vectors are freed one by one, nodes and keys with the arena
     for (size_t i = 0; i < dict->alloc; i++) {
-        fvdictNode* current = dict->keyValues[i].next;
-        while (current) {      
-            fvdictNode* next = current->next;
-
+        for (fvdictNode* current = dict->keyValues[i].next; current; current = current->next) {
             free_float_vector(current->value);
-            free(current->key);
-            free(current);
-
-            current = next;
         }
     }
 
-    // Free the hash table and dictionary struct
+    // Free the arena, hash table and dictionary struct
+    _arena_release(&dict->arena);
     free(dict->keyValues);
     free(dict);
 }
@@ -1772,15 +6153,8 @@ bool has_key_floatv_dict(const dict_fv* dict, const char* key) {
         return false;
     }
 
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
-
-    for (const fvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            return true;
-        }
-    }
-
-    return false;
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
+    return _fvdict_find(dict, &hk) != NULL;
 }
 // -------------------------------------------------------------------------------- 
 
@@ -1796,53 +6170,14 @@ bool insert_floatv_dict(dict_fv* dict, const char* key, float_v* value) {
         return false;
     }
 
-    // Resize if load factor exceeded
-    if (dict->hash_size >= dict->alloc * LOAD_FACTOR_THRESHOLD) {
-        size_t new_size = (dict->alloc < VEC_THRESHOLD)
-                          ? dict->alloc * 2
-                          : dict->alloc + VEC_FIXED_AMOUNT;
-
-        if (!resize_dictv(dict, new_size)) {
-            return false;
-        }
-    }
-
-    size_t index = hash_function(key, HASH_SEED) % dict->alloc;
+    hashed_key hk = _hash_key(key, dict->hash_fn, dict->seed);
 
     // Check for existing key
-    for (fvdictNode* current = dict->keyValues[index].next; current; current = current->next) {
-        if (strcmp(current->key, key) == 0) {
-            errno = EEXIST;
-            return false;
-        }
-    }
-
-    // Allocate new key string
-    char* new_key = strdup(key);
-    if (!new_key) {
-        errno = ENOMEM;
-        return false;
-    }
-
-    // Allocate node
-    fvdictNode* new_node = malloc(sizeof(fvdictNode));
-    if (!new_node) {
-        free(new_key);
-        errno = ENOMEM;
+    if (_fvdict_find(dict, &hk)) {
+        errno = EEXIST;
         return false;
     }
-
-    new_node->key = new_key;
-    new_node->value = value;
-    new_node->next = dict->keyValues[index].next;
-    dict->keyValues[index].next = new_node;
-
-    dict->hash_size++;
-    if (new_node->next == NULL) {
-        dict->len++;
-    }
-
-    return true;
+    return _fvdict_insert(dict, &hk, value);
 }
 // -------------------------------------------------------------------------------- 
 
@@ -1879,33 +6214,50 @@ dict_fv* copy_floatv_dict(const dict_fv* original) {
         return NULL;
     }
 
-    dict_fv* copy = init_floatv_dict();
+    dict_fv* copy = calloc(1, sizeof(dict_fv));
     if (!copy) {
-        return NULL;  // errno already set
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    // Chains are rebuilt in the same buckets and order, so no key is hashed
+    // or checked for duplicates.  Every key and node comes from one slab.
+    copy->keyValues = calloc(original->alloc, sizeof(fvdictNode));
+    if (!copy->keyValues || !_arena_reserve(&copy->arena, original->arena.live_bytes)) {
+        errno = ENOMEM;
+        free_floatv_dict(copy);
+        return NULL;
     }
+    copy->alloc = original->alloc;
+    copy->hash_fn = original->hash_fn;
+    copy->seed = original->seed;
 
     for (size_t i = 0; i < original->alloc; ++i) {
-        fvdictNode* current = original->keyValues[i].next;
-        while (current) {
-            // if (current->value->alloc_type != DYNAMIC) {
-            //     free_floatv_dict(copy);
-            //     errno = EPERM;
-            //     return NULL;
-            // }
-
+        fvdictNode* tail = &copy->keyValues[i];
+        for (const fvdictNode* current = original->keyValues[i].next; current;
+             current = current->next) {
             float_v* vec_copy = copy_float_vector(current->value);
             if (!vec_copy) {
                 free_floatv_dict(copy);
                 return NULL;
             }
 
-            if (!insert_floatv_dict(copy, current->key, vec_copy)) {
+            char* key = _arena_alloc(&copy->arena, current->key_len + 1);
+            fvdictNode* node = _arena_alloc(&copy->arena, sizeof(fvdictNode));
+            if (!key || !node) {
                 free_float_vector(vec_copy);
                 free_floatv_dict(copy);
                 return NULL;
             }
-
-            current = current->next;
+            memcpy(key, current->key, current->key_len + 1);
+            *node = *current;
+            node->key = key;
+            node->value = vec_copy;
+            node->next = NULL;
+            if (tail == &copy->keyValues[i]) copy->len++;
+            tail->next = node;
+            tail = node;
+            copy->hash_size++;
         }
     }
 
@@ -1975,9 +6327,7 @@ void clear_floatv_dict(dict_fv* dict) {
         fvdictNode* current = dict->keyValues[i].next;
         dict->keyValues[i].next = NULL;
 
-        while (current) {
-            fvdictNode* next = current->next;
-
+        for (; current; current = current->next) {
             if (current->value) {
                 if (current->value->alloc_type == STATIC) {
                     free(current->value);
@@ -1985,12 +6335,9 @@ void clear_floatv_dict(dict_fv* dict) {
                     free_float_vector(current->value);
                 }
             }
-
-            free(current->key);
-            free(current);
-            current = next;
         }
     }
+    _arena_release(&dict->arena);  // Nodes and keys go with their slabs
 
     dict->hash_size = 0;
     dict->len = 0;
@@ -2041,4 +6388,890 @@ string_v* get_keys_floatv_dict(const dict_fv* dict) {
 }
 // ================================================================================ 
 // ================================================================================ 
+// BINARY STORAGE
+//
+// A stored container is a 64 byte header, a table of fixed size entries, a
+// table of NUL terminated keys and the float data, which starts on a 64 byte
+// boundary.  Dictionary entries hold their key's offset in the key table, its
+// length and its hash, so a loader places every key without hashing it.  The
+// checksum chains c_float_hash_wy over 64 KiB blocks of everything after the
+// header, which lets a writer compute it while streaming and a loader verify
+// it in one pass over the image.
+
+#define FLOAT_STORE_MAGIC "CFLOATS"
+#define FLOAT_STORE_VERSION 1u
+#define FLOAT_STORE_ALIGN ((size_t)64)
+#define FLOAT_STORE_BLOCK ((size_t)1 << 16)
+#define FLOAT_STORE_CHECK_SEED 0x9e3779b97f4a7c15ull
+#define FLOAT_STORE_SORTED 1u   // Vector: in ascending order
+#define FLOAT_STORE_CHAINED 2u  // dict_f: DICT_CHAINED backend
+#define FLOAT_STORE_WYHASH 4u   // Entry hashes are c_float_hash_wy under the seed
+
+typedef enum {
+    STORE_VECTOR = 1,
+    STORE_DICT = 2,
+    STORE_DICTV = 3
+} store_kind;
+
+typedef struct {
+    char magic[8];      // FLOAT_STORE_MAGIC
+    uint32_t version;   // FLOAT_STORE_VERSION
+    uint32_t endian;    // FLOAT_FILE_ENDIAN in the byte order of the writer
+    uint32_t kind;      // store_kind
+    uint32_t flags;     // FLOAT_STORE_* bits
+    uint64_t count;     // Elements of a vector, entries of a dictionary
+    uint64_t seed;      // Seed of the entry hashes
+    uint64_t data;      // Offset of the float data
+    uint64_t bytes;     // Length of the file
+    uint64_t checksum;  // Of the bytes after the header
+} float_store_header;
+
+_Static_assert(sizeof(float_store_header) == 64, "store header must be 64 bytes");
+
+typedef struct {
+    uint64_t key;       // Offset of the key in the key table
+    uint64_t key_len;
+    uint64_t hash;
+} float_store_key;
+
+typedef struct {
+    float_store_key key;
+    uint64_t offset;    // Offset of the vector in the float data, in floats
+    uint64_t len;
+    uint64_t flags;     // FLOAT_STORE_SORTED
+} float_store_entry;
+// --------------------------------------------------------------------------------
+
+static inline size_t _store_align(size_t offset) {
+    return (offset + FLOAT_STORE_ALIGN - 1) & ~(FLOAT_STORE_ALIGN - 1);
+}
+// --------------------------------------------------------------------------------
+
+static uint64_t _store_checksum(const char* body, size_t len) {
+    uint64_t hash = FLOAT_STORE_CHECK_SEED;
+    for (size_t pos = 0; pos < len; pos += FLOAT_STORE_BLOCK) {
+        size_t block = len - pos < FLOAT_STORE_BLOCK ? len - pos : FLOAT_STORE_BLOCK;
+        hash = (uint64_t)c_float_hash_wy(body + pos, block, hash);
+    }
+    return hash;
+}
+// --------------------------------------------------------------------------------
+
+/*
+ * Writers, and readers that fill several buffers, stream the body through
+ * stdio.  Whole blocks are hashed where they lie, and only the pieces of
+ * blocks that span two calls are gathered in block, so the checksum matches
+ * _store_checksum over the whole file.
+ */
+typedef struct {
+    FILE* file;
+    const float_store_header* header;
+    uint64_t hash;
+    size_t fill;        // Bytes waiting in block
+    size_t done;        // Bytes of the body written or read so far
+    bool ok;
+    char block[FLOAT_STORE_BLOCK];
+} store_stream;
+// --------------------------------------------------------------------------------
+
+static store_stream* _store_stream(FILE* file, const float_store_header* header) {
+    store_stream* s = malloc(sizeof(store_stream));
+    if (!s) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    s->file = file;
+    s->header = header;
+    s->hash = FLOAT_STORE_CHECK_SEED;
+    s->fill = 0;
+    s->done = 0;
+    s->ok = true;
+    return s;
+}
+// --------------------------------------------------------------------------------
+
+static void _store_hash(store_stream* s, const char* data, size_t len) {
+    s->done += len;
+    while (len > 0) {
+        if (s->fill == 0 && len >= FLOAT_STORE_BLOCK) {
+            s->hash = (uint64_t)c_float_hash_wy(data, FLOAT_STORE_BLOCK, s->hash);
+            data += FLOAT_STORE_BLOCK;
+            len -= FLOAT_STORE_BLOCK;
+            continue;
+        }
+        size_t part = FLOAT_STORE_BLOCK - s->fill < len ? FLOAT_STORE_BLOCK - s->fill : len;
+        memcpy(s->block + s->fill, data, part);
+        s->fill += part;
+        data += part;
+        len -= part;
+        if (s->fill == FLOAT_STORE_BLOCK) {
+            s->hash = (uint64_t)c_float_hash_wy(s->block, FLOAT_STORE_BLOCK, s->hash);
+            s->fill = 0;
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+static uint64_t _store_digest(store_stream* s) {
+    // Hashes the last, partial block
+    if (s->fill > 0) {
+        s->hash = (uint64_t)c_float_hash_wy(s->block, s->fill, s->hash);
+        s->fill = 0;
+    }
+    return s->hash;
+}
+// --------------------------------------------------------------------------------
+
+static void _store_put(store_stream* s, const void* data, size_t len) {
+    if (!s->ok || len == 0) return;
+    if (fwrite(data, 1, len, s->file) != len) {
+        s->ok = false;
+        return;
+    }
+    _store_hash(s, data, len);
+}
+// --------------------------------------------------------------------------------
+
+static void _store_get(store_stream* s, void* data, size_t len) {
+    if (!s->ok || len == 0) return;
+    if (fread(data, 1, len, s->file) != len) {
+        s->ok = false;
+        return;
+    }
+    _store_hash(s, data, len);
+}
+// --------------------------------------------------------------------------------
+
+static void _store_pad(store_stream* s, size_t offset) {
+    // Writes zeros up to file offset, which is past the header
+    static const char zeros[FLOAT_STORE_ALIGN];
+    while (s->ok && sizeof(float_store_header) + s->done < offset) {
+        size_t gap = offset - sizeof(float_store_header) - s->done;
+        _store_put(s, zeros, gap < sizeof(zeros) ? gap : sizeof(zeros));
+    }
+}
+// --------------------------------------------------------------------------------
+
+static void _store_skip(store_stream* s, size_t offset) {
+    // Reads past the padding up to file offset
+    char scratch[FLOAT_STORE_ALIGN];
+    while (s->ok && sizeof(float_store_header) + s->done < offset) {
+        size_t gap = offset - sizeof(float_store_header) - s->done;
+        _store_get(s, scratch, gap < sizeof(scratch) ? gap : sizeof(scratch));
+    }
+}
+// --------------------------------------------------------------------------------
+
+typedef void (*store_body)(store_stream* w, const void* src);
+// --------------------------------------------------------------------------------
+
+static FILE* _store_temp(const char* path, char* temp) {
+    // Creates the temporary file a save writes before it is renamed to path.
+    // It takes the permissions of the file it replaces, or those fopen
+    // would give a new file without a umask tighter than 022
+#if defined(C_FLOAT_ATOMIC_SAVE)
+    int fd = mkstemp(temp);
+    if (fd < 0) return NULL;
+    struct stat info;
+    mode_t perm = stat(path, &info) == 0 ? info.st_mode & 07777 : 0644;
+    FILE* file = fchmod(fd, perm) == 0 ? fdopen(fd, "wb") : NULL;
+    if (!file) {
+        int err = errno;
+        close(fd);
+        remove(temp);
+        errno = err;
+    }
+    return file;
+#else
+    (void)path;
+    return fopen(temp, "wb");
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static bool _store_write(const char* path, float_store_header* header, store_body body,
+                         const void* src) {
+    // Writes header, streams the body, then rewrites the header with the
+    // checksum.  Everything goes to a temporary file beside path that is
+    // renamed over it once complete, so a failed write leaves path untouched
+    memcpy(header->magic, FLOAT_STORE_MAGIC, sizeof(FLOAT_STORE_MAGIC));
+    header->version = FLOAT_STORE_VERSION;
+    header->endian = FLOAT_FILE_ENDIAN;
+    static const char suffix[] = ".XXXXXX";
+    size_t len = strlen(path);
+    char* temp = malloc(len + sizeof(suffix));
+    if (!temp) {
+        errno = ENOMEM;
+        return false;
+    }
+    memcpy(temp, path, len);
+    memcpy(temp + len, suffix, sizeof(suffix));
+    FILE* file = _store_temp(path, temp);
+    if (!file) {
+        free(temp);
+        return false;
+    }
+    store_stream* w = _store_stream(file, header);
+    if (!w) {
+        fclose(file);
+        remove(temp);
+        free(temp);
+        errno = ENOMEM;
+        return false;
+    }
+    w->ok = fwrite(header, sizeof(*header), 1, file) == 1;
+    body(w, src);
+    header->checksum = _store_digest(w);
+    bool ok = w->ok && sizeof(*header) + w->done == header->bytes &&
+              fseek(w->file, 0, SEEK_SET) == 0 &&
+              fwrite(header, sizeof(*header), 1, w->file) == 1 && fflush(w->file) == 0;
+#if defined(C_FLOAT_ATOMIC_SAVE)
+    ok = ok && fsync(fileno(w->file)) == 0;
+#endif
+    int err = ok ? 0 : errno ? errno : EIO;
+    if (fclose(w->file) != 0 && ok) {
+        ok = false;
+        err = errno ? errno : EIO;
+    }
+    free(w);
+#if !defined(C_FLOAT_ATOMIC_SAVE)
+    // rename does not replace an existing file outside POSIX
+    if (ok) remove(path);
+#endif
+    if (ok && rename(temp, path) != 0) {
+        ok = false;
+        err = errno ? errno : EIO;
+    }
+    if (!ok) {
+        remove(temp);
+        errno = err;
+    }
+    free(temp);
+    return ok;
+}
+// --------------------------------------------------------------------------------
+
+static bool _store_check(const char* image, size_t bytes, store_kind kind, size_t entry_size,
+                         bool verify) {
+    // Validates the header against the image so every offset the loaders
+    // follow lies inside it
+    if (bytes < sizeof(float_store_header)) {
+        errno = EINVAL;
+        return false;
+    }
+    const float_store_header* header = (const float_store_header*)image;
+    size_t entries_end = sizeof(float_store_header);
+    bool ok = memcmp(header->magic, FLOAT_STORE_MAGIC, sizeof(FLOAT_STORE_MAGIC)) == 0 &&
+              header->version == FLOAT_STORE_VERSION && header->endian == FLOAT_FILE_ENDIAN &&
+              header->kind == (uint32_t)kind && header->bytes == bytes &&
+              header->data % FLOAT_STORE_ALIGN == 0 && header->data <= bytes &&
+              header->count <= (bytes - sizeof(float_store_header)) / (entry_size ? entry_size : 1);
+    if (ok) {
+        entries_end += (size_t)header->count * entry_size;
+        ok = entries_end <= header->data;
+    }
+    if (ok && kind != STORE_DICTV) {
+        // The vector or the dictionary values follow the data offset directly
+        ok = header->count <= (bytes - header->data) / sizeof(float);
+    }
+    if (ok && kind == STORE_VECTOR) {
+        ok = header->data == sizeof(float_store_header) &&
+             bytes == header->data + header->count * sizeof(float);
+    }
+    if (!ok) {
+        errno = EINVAL;
+        return false;
+    }
+    if (verify && _store_checksum(image + sizeof(float_store_header),
+                                  bytes - sizeof(float_store_header)) != header->checksum) {
+        errno = EIO;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static const char* _store_key(const char* image, const float_store_key* key, size_t* len) {
+    // Returns the NUL terminated key an entry names, or NULL if it lies
+    // outside the key table
+    const float_store_header* header = (const float_store_header*)image;
+    const size_t table = sizeof(float_store_header) +
+                         (size_t)header->count * (header->kind == STORE_DICT
+                                                  ? sizeof(float_store_key)
+                                                  : sizeof(float_store_entry));
+    const size_t size = (size_t)header->data - table;
+    if (key->key >= size || key->key_len >= size - key->key) return NULL;
+    const char* text = image + table + key->key;
+    if (text[key->key_len] != '\0') return NULL;
+    *len = (size_t)key->key_len;
+    return text;
+}
+// --------------------------------------------------------------------------------
+
+static char* _store_read(const char* path, size_t* bytes) {
+    // Reads a stored container with one read after its header.  The buffer
+    // has room for the header, so data offsets apply to it unchanged.
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    float_store_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, FLOAT_STORE_MAGIC, sizeof(FLOAT_STORE_MAGIC)) != 0 ||
+        header.bytes < sizeof(header) || header.bytes > SIZE_MAX) {
+        fclose(file);
+        errno = EINVAL;
+        return NULL;
+    }
+    char* image = malloc((size_t)header.bytes);
+    if (!image) {
+        fclose(file);
+        errno = ENOMEM;
+        return NULL;
+    }
+    memcpy(image, &header, sizeof(header));
+    size_t rest = (size_t)header.bytes - sizeof(header);
+    bool ok = fread(image + sizeof(header), 1, rest, file) == rest && fgetc(file) == EOF;
+    fclose(file);
+    if (!ok) {
+        free(image);
+        errno = EINVAL;  // The file is shorter or longer than its header says
+        return NULL;
+    }
+    *bytes = (size_t)header.bytes;
+    return image;
+}
+// --------------------------------------------------------------------------------
+
+#if defined(C_FLOAT_MMAP)
+static float_file* _store_map(const char* path) {
+    // Maps a stored file privately, so views of it can be modified in
+    // memory without changing the file.  The descriptor is not kept.
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    if (bytes < sizeof(float_store_header)) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+    void* base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+        errno = err;
+        return NULL;
+    }
+    float_file* file = malloc(sizeof(float_file));
+    if (!file) {
+        munmap(base, bytes);
+        errno = ENOMEM;
+        return NULL;
+    }
+    file->base = base;
+    file->bytes = bytes;
+    file->fd = -1;
+    file->writable = false;
+    file->refs = 1;
+    return file;
+}
+#endif
+// --------------------------------------------------------------------------------
+
+static const char* _store_open(const char* path, load_mode mode, float_file** file,
+                               size_t* bytes) {
+    // Brings a stored file into memory the way mode asks.  A mapped image
+    // is owned by *file, a read one by the caller.
+    *file = NULL;
+    if (!path || (mode != LOAD_READ && mode != LOAD_MAP)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (mode == LOAD_READ) return _store_read(path, bytes);
+#if defined(C_FLOAT_MMAP)
+    *file = _store_map(path);
+    if (!*file) return NULL;
+    *bytes = (*file)->bytes;
+    return (*file)->base;
+#else
+    errno = ENOTSUP;
+    return NULL;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static void _store_close(const char* image, float_file* file) {
+    // Drops the loader's hold on an image from _store_open
+#if defined(C_FLOAT_MMAP)
+    if (file) {
+        _file_release(file);
+        return;
+    }
+#else
+    (void) file;
+#endif
+    free((void*)image);
+}
+// --------------------------------------------------------------------------------
+
+static void _store_vector_body(store_stream* w, const void* src) {
+    const float_v* vec = src;
+    _store_put(w, vec->data, vec->len * sizeof(float));
+}
+// --------------------------------------------------------------------------------
+
+bool save_float_vector(const float_v* vec, const char* path) {
+    if (!vec || !vec->data || !path) {
+        errno = EINVAL;
+        return false;
+    }
+    float_store_header header = {0};
+    header.kind = STORE_VECTOR;
+    header.flags = vec->sorted ? FLOAT_STORE_SORTED : 0;
+    header.count = vec->len;
+    header.data = sizeof(header);
+    header.bytes = sizeof(header) + vec->len * sizeof(float);
+    return _store_write(path, &header, _store_vector_body, vec);
+}
+// --------------------------------------------------------------------------------
+
+float_v* load_float_vector(const char* path, load_mode mode, bool verify) {
+    if (!path || (mode != LOAD_READ && mode != LOAD_MAP)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    float_v* vec = malloc(sizeof(float_v));
+    if (!vec) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    vec->alloc_type = DYNAMIC;
+    vec->mapped = false;
+    vec->file = NULL;
+
+    if (mode == LOAD_MAP) {
+        float_file* file = NULL;
+        size_t bytes = 0;
+        const char* image = _store_open(path, mode, &file, &bytes);
+        if (!image || !_store_check(image, bytes, STORE_VECTOR, 0, verify)) {
+            int err = errno;
+            if (image) _store_close(image, file);
+            free(vec);
+            errno = err;
+            return NULL;
+        }
+        // The vector is a view of the floats after the header, so nothing
+        // is read until it is used.  An empty one has nothing to view.
+        const float_store_header* header = (const float_store_header*)image;
+        if (header->count == 0) {
+            _store_close(image, file);
+            free(vec);
+            return init_float_vector(1);
+        }
+        vec->data = (float*)(image + header->data);
+        vec->len = (size_t)header->count;
+        vec->alloc = vec->len;
+        vec->front = 0;
+        vec->sorted = vec->len <= 1 || (header->flags & FLOAT_STORE_SORTED);
+        vec->file = file;
+        return vec;
+    }
+
+    // The file is read straight into the vector's buffer.  The header lands
+    // in the slots before data, which become free front slots.
+    FILE* stream = fopen(path, "rb");
+    if (!stream) {
+        free(vec);
+        return NULL;
+    }
+    float_store_header header;
+    size_t slots = 0;
+    bool ok = fread(&header, sizeof(header), 1, stream) == 1 &&
+              header.bytes >= sizeof(header) && header.bytes % sizeof(float) == 0 &&
+              header.bytes <= SIZE_MAX;
+    if (ok) slots = (size_t)header.bytes / sizeof(float);
+    float* base = ok ? _buf_new(slots, &vec->mapped) : NULL;
+    if (!base) {
+        fclose(stream);
+        free(vec);
+        errno = ok ? ENOMEM : EINVAL;
+        return NULL;
+    }
+    memcpy(base, &header, sizeof(header));
+    size_t rest = (size_t)header.bytes - sizeof(header);
+    ok = fread((char*)base + sizeof(header), 1, rest, stream) == rest && fgetc(stream) == EOF;
+    fclose(stream);
+    if (!ok) errno = EINVAL;
+    ok = ok && _store_check((const char*)base, (size_t)header.bytes, STORE_VECTOR, 0, verify);
+    if (!ok) {
+        int err = errno;
+        _buf_free(base, slots, vec->mapped);
+        free(vec);
+        errno = err;
+        return NULL;
+    }
+    const size_t front = sizeof(header) / sizeof(float);
+    memset(base, 0, sizeof(header));
+    vec->data = base + front;
+    vec->len = slots - front;
+    vec->alloc = vec->len;
+    vec->front = front;
+    vec->sorted = vec->len <= 1 || (header.flags & FLOAT_STORE_SORTED);
+    return vec;
+}
+// --------------------------------------------------------------------------------
+
+static void _store_dict_body(store_stream* w, const void* src) {
+    // Entries, keys and values all follow insertion order
+    const dict_f* dict = src;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        const fdictEntry* entry = &dict->entries[i];
+        float_store_key key = {offset, entry->key_len, entry->hash};
+        _store_put(w, &key, sizeof(key));
+        offset += entry->key_len + 1;
+    }
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        _store_put(w, dict->entries[i].key, dict->entries[i].key_len + 1);
+    }
+    _store_pad(w, (size_t)w->header->data);
+    _store_put(w, dict->values, dict->hash_size * sizeof(float));
+}
+// --------------------------------------------------------------------------------
+
+bool save_float_dict(const dict_f* dict, const char* path) {
+    if (!dict || !path) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t keys = 0;
+    for (size_t i = 0; i < dict->hash_size; i++) {
+        keys += dict->entries[i].key_len + 1;
+    }
+    float_store_header header = {0};
+    header.kind = STORE_DICT;
+    header.flags = (dict->backend == DICT_CHAINED ? FLOAT_STORE_CHAINED : 0) |
+                   (dict->hash_fn == c_float_hash_wy ? FLOAT_STORE_WYHASH : 0);
+    header.count = dict->hash_size;
+    header.seed = dict->seed;
+    header.data = _store_align(sizeof(header) + dict->hash_size * sizeof(float_store_key) + keys);
+    header.bytes = header.data + dict->hash_size * sizeof(float);
+    return _store_write(path, &header, _store_dict_body, dict);
+}
+// --------------------------------------------------------------------------------
+
+dict_f* load_float_dict(const char* path, load_mode mode, bool verify) {
+    float_file* file = NULL;
+    size_t bytes = 0;
+    const char* image = _store_open(path, mode, &file, &bytes);
+    if (!image) return NULL;
+    if (!_store_check(image, bytes, STORE_DICT, sizeof(float_store_key), verify)) {
+        int err = errno;
+        _store_close(image, file);
+        errno = err;
+        return NULL;
+    }
+    const float_store_header* header = (const float_store_header*)image;
+    const float_store_key* keys = (const float_store_key*)(image + sizeof(*header));
+    const size_t count = (size_t)header->count;
+    const bool hashed = header->flags & FLOAT_STORE_WYHASH;
+
+    dict_f* dict = init_float_dict_ex(header->flags & FLOAT_STORE_CHAINED ? DICT_CHAINED
+                                                                         : DICT_OPEN);
+    bool ok = dict && reserve_float_dict(dict, count);
+    if (ok && hashed) dict->seed = header->seed;
+
+    // A mapped image lends the dictionary its keys and values.  A read one
+    // is copied, keys into one slab and values in one block.
+    const bool view = file && count > 0;
+    if (ok && !view) {
+        size_t table = (size_t)header->data - sizeof(*header) - count * sizeof(float_store_key);
+        ok = _arena_reserve(&dict->arena, table + count * DICT_ARENA_ALIGN);
+    }
+    for (size_t i = 0; ok && i < count; i++) {
+        size_t len = 0;
+        const char* key = _store_key(image, &keys[i], &len);
+        if (!key) {
+            errno = EINVAL;
+            ok = false;
+            break;
+        }
+        char* stored = (char*)key;
+        if (!view) {
+            stored = _arena_alloc(&dict->arena, len + 1);
+            if (!stored) {
+                ok = false;
+                break;
+            }
+            memcpy(stored, key, len + 1);
+        }
+        // Stored hashes place the entries without reading a key
+        size_t hash = hashed ? (size_t)keys[i].hash : dict->hash_fn(key, len, dict->seed);
+        dict->entries[i] = (fdictEntry){stored, len, hash, DICT_NONE};
+    }
+    if (!ok) {
+        int err = errno;
+        free_float_dict(dict);
+        _store_close(image, file);
+        errno = err;
+        return NULL;
+    }
+
+    const float* values = (const float*)(image + header->data);
+    if (view) {
+        // The mapped values are count slots long, so the first insert moves
+        // them to the heap
+        free(dict->values);
+        dict->values = (float*)values;
+        dict->entry_alloc = count;
+        dict->view_values = true;
+        dict->view = file;
+    } else {
+        memcpy(dict->values, values, count * sizeof(float));
+        _store_close(image, file);
+    }
+    dict->hash_size = count;
+    dict->len = count;
+    _fdict_rebuild(dict);
+    return dict;
+}
+// --------------------------------------------------------------------------------
+
+static void _store_dictv_body(store_stream* w, const void* src) {
+    // Entries, keys and vectors all follow bucket order
+    const dict_fv* dict = src;
+    uint64_t key_offset = 0;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < dict->alloc; i++) {
+        for (const fvdictNode* node = dict->keyValues[i].next; node; node = node->next) {
+            float_store_entry entry = {{key_offset, node->key_len, node->hash}, offset,
+                                       node->value->len,
+                                       node->value->sorted ? FLOAT_STORE_SORTED : 0};
+            _store_put(w, &entry, sizeof(entry));
+            key_offset += node->key_len + 1;
+            offset += _store_align(node->value->len * sizeof(float)) / sizeof(float);
+        }
+    }
+    for (size_t i = 0; i < dict->alloc; i++) {
+        for (const fvdictNode* node = dict->keyValues[i].next; node; node = node->next) {
+            _store_put(w, node->key, node->key_len + 1);
+        }
+    }
+    // Every vector starts on a 64 byte boundary
+    for (size_t i = 0; i < dict->alloc; i++) {
+        for (const fvdictNode* node = dict->keyValues[i].next; node; node = node->next) {
+            _store_pad(w, _store_align(sizeof(float_store_header) + w->done));
+            _store_put(w, node->value->data, node->value->len * sizeof(float));
+        }
+    }
+    _store_pad(w, (size_t)w->header->bytes);
+}
+// --------------------------------------------------------------------------------
+
+bool save_floatv_dict(const dict_fv* dict, const char* path) {
+    if (!dict || !path) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t keys = 0;
+    size_t data = 0;
+    for (size_t i = 0; i < dict->alloc; i++) {
+        for (const fvdictNode* node = dict->keyValues[i].next; node; node = node->next) {
+            keys += node->key_len + 1;
+            data += _store_align(node->value->len * sizeof(float));
+        }
+    }
+    float_store_header header = {0};
+    header.kind = STORE_DICTV;
+    header.flags = dict->hash_fn == c_float_hash_wy ? FLOAT_STORE_WYHASH : 0;
+    header.count = dict->hash_size;
+    header.seed = dict->seed;
+    header.data = _store_align(sizeof(header) + dict->hash_size * sizeof(float_store_entry) +
+                               keys);
+    header.bytes = header.data + data;
+    return _store_write(path, &header, _store_dictv_body, dict);
+}
+// --------------------------------------------------------------------------------
+
+static bool _store_dictv_entry(dict_fv* dict, const char* image, const float_store_entry* entry,
+                               float_v* vec) {
+    // Names vec with the entry's key and adds it to dict.  On failure vec
+    // is freed.
+    const float_store_header* header = (const float_store_header*)image;
+    size_t key_len = 0;
+    const char* key = _store_key(image, &entry->key, &key_len);
+    if (!key) {
+        free_float_vector(vec);
+        errno = EINVAL;
+        return false;
+    }
+    vec->sorted = vec->len <= 1 || (entry->flags & FLOAT_STORE_SORTED);
+    hashed_key hk = {key, key_len,
+                     header->flags & FLOAT_STORE_WYHASH
+                     ? (size_t)entry->key.hash : dict->hash_fn(key, key_len, dict->seed)};
+    if (!_fvdict_insert(dict, &hk, vec)) {
+        free_float_vector(vec);
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static dict_fv* _store_dictv_init(const float_store_header* header) {
+    // An empty dictionary with the stored seed and room for every entry
+    dict_fv* dict = init_floatv_dict();
+    if (!dict) return NULL;
+    if (header->flags & FLOAT_STORE_WYHASH) dict->seed = header->seed;
+    const size_t count = (size_t)header->count;
+    if (count >= dict->alloc * LOAD_FACTOR_THRESHOLD &&
+        !resize_dictv(dict, (size_t)(count / LOAD_FACTOR_THRESHOLD) + 1)) {
+        free_floatv_dict(dict);
+        return NULL;
+    }
+    return dict;
+}
+// --------------------------------------------------------------------------------
+
+static dict_fv* _store_read_dictv(const char* path, bool verify) {
+    // Reads the header, entries and keys, then each vector straight into
+    // its own buffer, hashing the file on the way
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    float_store_header header;
+    char* meta = NULL;
+    store_stream* s = NULL;
+    dict_fv* dict = NULL;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              header.data >= sizeof(header) && header.data <= header.bytes &&
+              header.bytes <= SIZE_MAX;
+    if (!ok) errno = EINVAL;
+    if (ok) {
+        meta = malloc((size_t)header.data);
+        s = _store_stream(file, (const float_store_header*)meta);
+        ok = meta && s;
+        if (!ok) errno = ENOMEM;
+    }
+    if (ok) {
+        memcpy(meta, &header, sizeof(header));
+        _store_get(s, meta + sizeof(header), (size_t)header.data - sizeof(header));
+        if (!s->ok) errno = EINVAL;
+        ok = s->ok && _store_check(meta, (size_t)header.bytes, STORE_DICTV,
+                                   sizeof(float_store_entry), false);
+    }
+    if (ok) {
+        dict = _store_dictv_init(&header);
+        ok = dict != NULL;
+    }
+
+    // Entries list the vectors in file order, so every read follows the last
+    const float_store_entry* entries = (const float_store_entry*)(meta + sizeof(header));
+    const size_t floats = ok ? ((size_t)header.bytes - (size_t)header.data) / sizeof(float) : 0;
+    for (size_t i = 0; ok && i < (size_t)header.count; i++) {
+        const float_store_entry* entry = &entries[i];
+        if (entry->offset > floats || entry->len > floats - entry->offset ||
+            header.data + entry->offset * sizeof(float) < sizeof(header) + s->done) {
+            errno = EINVAL;
+            ok = false;
+            break;
+        }
+        const size_t len = (size_t)entry->len;
+        float_v* vec = init_float_vector(len ? len : 1);
+        if (!vec) {
+            ok = false;
+            break;
+        }
+        _store_skip(s, (size_t)header.data + (size_t)entry->offset * sizeof(float));
+        _store_get(s, vec->data, len * sizeof(float));
+        vec->len = len;
+        if (!s->ok) {
+            free_float_vector(vec);
+            errno = EINVAL;
+            ok = false;
+            break;
+        }
+        ok = _store_dictv_entry(dict, meta, entry, vec);
+    }
+    if (ok) {
+        _store_skip(s, (size_t)header.bytes);
+        ok = s->ok && fgetc(file) == EOF;
+        if (!ok) errno = EINVAL;  // The file is shorter or longer than its header says
+    }
+    if (ok && verify && _store_digest(s) != header.checksum) {
+        errno = EIO;
+        ok = false;
+    }
+    int err = errno;
+    fclose(file);
+    free(s);
+    free(meta);
+    if (!ok) {
+        free_floatv_dict(dict);
+        errno = err;
+        return NULL;
+    }
+    return dict;
+}
+// --------------------------------------------------------------------------------
+
+dict_fv* load_floatv_dict(const char* path, load_mode mode, bool verify) {
+    if (path && mode == LOAD_READ) return _store_read_dictv(path, verify);
+    float_file* file = NULL;
+    size_t bytes = 0;
+    const char* image = _store_open(path, mode, &file, &bytes);
+    if (!image) return NULL;
+    if (!_store_check(image, bytes, STORE_DICTV, sizeof(float_store_entry), verify)) {
+        int err = errno;
+        _store_close(image, file);
+        errno = err;
+        return NULL;
+    }
+    const float_store_header* header = (const float_store_header*)image;
+    const float_store_entry* entries = (const float_store_entry*)(image + sizeof(*header));
+    const size_t floats = (bytes - (size_t)header->data) / sizeof(float);
+    const float* data = (const float*)(image + header->data);
+
+    dict_fv* dict = _store_dictv_init(header);
+    bool ok = dict != NULL;
+    for (size_t i = 0; ok && i < (size_t)header->count; i++) {
+        const float_store_entry* entry = &entries[i];
+        if (entry->offset > floats || entry->len > floats - entry->offset) {
+            errno = EINVAL;
+            ok = false;
+            break;
+        }
+        // Each vector views its floats in the shared mapping.  An empty one
+        // has nothing to view.
+        const size_t len = (size_t)entry->len;
+        float_v* vec = len ? malloc(sizeof(float_v)) : init_float_vector(1);
+        if (!vec) {
+            errno = ENOMEM;
+            ok = false;
+            break;
+        }
+        if (len) {
+            vec->data = (float*)(data + entry->offset);
+            vec->len = len;
+            vec->alloc = len;
+            vec->front = 0;
+            vec->alloc_type = DYNAMIC;
+            vec->mapped = false;
+            vec->file = file;
+            file->refs++;
+        }
+        ok = _store_dictv_entry(dict, image, entry, vec);
+    }
+    int err = errno;
+    if (!ok) free_floatv_dict(dict);
+    _store_close(image, file);
+    if (!ok) {
+        errno = err;
+        return NULL;
+    }
+    return dict;
+}
+// ================================================================================ 
+// ================================================================================ 
 // eof
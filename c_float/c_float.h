@@ -19,6 +19,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "c_string.h"
 // ================================================================================ 
 // ================================================================================ 
@@ -60,18 +61,49 @@ extern "C" {
 
 #endif /*ALLOC_H*/
 
+/**
+ * @typedef float_file
+ * @brief Opaque state of a vector whose buffer is a mapped file, or a view
+ *        into a container loaded with LOAD_MAP
+ */
+typedef struct float_file float_file;
+// --------------------------------------------------------------------------------
+
 /**
 * @struct float_v
 * @brief Dynamic array (vector) container for float objects
 *
 * This structure manages a resizable array of float objects with automatic
 * memory management and capacity handling.
+*
+* The sorted member is true while the library knows the data to be in
+* ascending order with any NaN values last.  Every library function that
+* changes the data keeps it up to date, and sorting in FORWARD order sets it.
+* Code that writes through data directly must not rely on it; c_float_ptr
+* clears it for that reason.
+*
+* The elements always occupy data[0] to data[len - 1] contiguously, but the
+* buffer may hold free slots before data as well as after it.  alloc counts
+* the slots from data onward and front the free slots before it.
+* pop_front_float_vector hands its slot to front instead of moving the
+* remaining elements, and push_front_float_vector takes a slot back from it,
+* so the vector works as a double-ended queue with O(1) amortized operations
+* at both ends.
+*
+* The mapped member is true when the buffer is an anonymous memory mapping
+* instead of a heap block; see set_float_vector_mmap_threshold.  The file
+* member is non-NULL when the buffer is a mapped file; see
+* open_float_vector_file.
 */
 typedef struct {
     float* data;
     size_t len;
     size_t alloc;
+    size_t front;
     alloc_t alloc_type;
+    bool sorted;
+    bool mapped;
+    float_file* file;
 } float_v;
 // --------------------------------------------------------------------------------
 
@@ -93,7 +125,8 @@ float_v* init_float_vector(size_t buffer);
  * @param size Size of the array
  */
 #define init_float_array(size) \
-    ((float_v){.data = (float[size]){0}, .len = 0, .alloc = size, .alloc_type = STATIC})
+    ((float_v){.data = (float[size]){0}, .len = 0, .alloc = size, .front = 0, \
+               .alloc_type = STATIC, .sorted = true, .mapped = false, .file = NULL})
 // -------------------------------------------------------------------------------- 
 
 /**
@@ -109,7 +142,10 @@ float* c_float_ptr(float_v* vec);
 * @function push_back_float_vector
 * @brief Adds a float value to the end of the vector
 *
-* Automatically resizes the vector if necessary.
+* Automatically resizes the vector if necessary.  When the vector has been
+* drained from the front by at least as many slots as it holds elements, the
+* elements are moved back to the start of the buffer instead, so a vector
+* used as a FIFO queue stays within a bounded buffer.
 *
 * @param vec Target float vector
 * @param value Float value to add
@@ -123,7 +159,10 @@ bool push_back_float_vector(float_v* vec, const float value);
 * @function push_front_float_vector
 * @brief Adds a float value to the beginning of the vector
 *
-* Shifts existing elements right and automatically resizes if necessary.
+* Uses a free slot before the first element when there is one.  Otherwise
+* shifts the elements right by half of the free slots after them if there are
+* at least as many free slots as elements, or else grows the buffer and
+* centres the elements in it.  Either way n calls move O(n) elements in total.
 *
 * @param vec Target float vector
 * @param value Float value to add
@@ -137,7 +176,9 @@ bool push_front_float_vector(float_v* vec, const float value);
 * @function insert_float_vector
 * @brief Inserts a float value at specified index in the vector
 *
-* Shifts elements right starting at index and resizes if necessary.
+* Shifts elements right starting at index and resizes if necessary.  When
+* there is a free slot before the first element and index lies in the first
+* half, the elements before index shift left into it instead.
 *
 * @param vec Target float vector
 * @param value Float value to insert
@@ -175,6 +216,9 @@ const size_t float_vector_size(const float_v* vec);
 * @function float_vector_alloc
 * @brief Returns current allocation size of vector
 *
+* Counts every slot of the buffer, including free slots before the first
+* element.
+*
 * @param vec Float vector to query
 * @return Current allocation capacity, or LONG_MAX on error
 *         Sets errno to EINVAL for NULL input
@@ -197,7 +241,8 @@ float pop_back_float_vector(float_v* vec);
 * @function pop_front_float_vector
 * @brief Removes and returns first float value in vector
 *
-* Shifts remaining elements left.
+* Runs in O(1): the vacated slot becomes a free slot before the new first
+* element, and no element moves.
 *
 * @param vec Source string vector
 * @return Pointer to removed float object, or NULL if vector empty
@@ -210,7 +255,9 @@ float pop_front_float_vector(float_v* vec);
 * @function pup_any_float_vector
 * @brief Removes and returns float value at specified index
 *
-* Shifts remaining elements left to fill gap.
+* Shifts the shorter side of the vector to fill the gap: elements after
+* index move left, or elements before it move right and their first slot
+* becomes free.
 *
 * @param vec Source float vector
 * @param index Position to remove from
@@ -290,8 +337,10 @@ void swap_float(float* a, float* b);
 * @brief Sorts a float vector in ascending or descending order.
 *
 * Uses an optimized QuickSort algorithm with median-of-three pivot selection
-* and insertion sort for small subarrays. Sort direction is determined by
-* the iter_dir parameter.
+* and insertion sort for small subarrays, or an LSD radix sort for vectors
+* of a few hundred elements or more (SORT_AUTO). Sort direction is
+* determined by the iter_dir parameter. NaN values are placed after every
+* number in both directions.
 *
 * @param vec float vector to sort
 * @param direction FORWARD for ascending order, REVERSE for descending
@@ -301,10 +350,111 @@ void swap_float(float* a, float* b);
 void sort_float_vector(float_v* vec, iter_dir direction);
 // -------------------------------------------------------------------------------- 
 
+/**
+ * @enum sort_mode
+ * @brief Algorithms available to sort_float_vector_ex
+ *
+ * @attribute SORT_AUTO Quicksort for short vectors, radix sort for long ones
+ * @attribute SORT_QUICK Quicksort with insertion sort for small partitions
+ * @attribute SORT_RADIX LSD radix sort on the IEEE-754 bit pattern; O(n) but
+ *            needs a scratch buffer the size of the vector
+ */
+typedef enum {
+    SORT_AUTO,
+    SORT_QUICK,
+    SORT_RADIX
+} sort_mode;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function sort_float_vector_ex
+ * @brief Sorts a float vector with a selectable algorithm
+ *
+ * Every mode gives the same order: ascending or descending by value with
+ * NaN values last.  -0.0 and 0.0 compare equal under SORT_QUICK, while
+ * SORT_RADIX orders -0.0 before 0.0 in ascending sorts.  SORT_AUTO falls back
+ * to quicksort if the radix scratch buffer cannot be allocated.
+ *
+ * @param vec float vector to sort
+ * @param direction FORWARD for ascending order, REVERSE for descending
+ * @param mode The sorting algorithm
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec
+ *         is NULL or direction or mode are unknown, or to ENOMEM if
+ *         SORT_RADIX cannot allocate its scratch buffer
+ */
+bool sort_float_vector_ex(float_v* vec, iter_dir direction, sort_mode mode);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function parallel_sort_float_vector
+ * @brief Sorts a float vector on several threads with a parallel sample sort
+ *
+ * A sorted random sample picks splitters that divide the values into buckets.
+ * The threads count and scatter their blocks into those buckets, then sort
+ * whole buckets independently with the radix or quicksort leaves.  The result
+ * has the same order as sort_float_vector, including NaN values last, and
+ * indices are size_t throughout so vectors longer than 2^31 elements are
+ * supported.  Vectors below about one million elements, or a thread count of
+ * 1, use sort_float_vector_ex with SORT_AUTO.  If the scratch buffer cannot
+ * be allocated the vector is sorted serially.  Heavily repeated values can
+ * concentrate in one bucket, which then sorts on a single thread.
+ *
+ * @param vec float vector to sort
+ * @param direction FORWARD for ascending order, REVERSE for descending
+ * @param nthreads Most threads to use, or 0 for float_thread_count().  The
+ *        pool size set by set_float_thread_count is an upper bound
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if vec
+ *         is NULL, direction is unknown or nthreads is larger than 1024
+ */
+bool parallel_sort_float_vector(float_v* vec, iter_dir direction, size_t nthreads);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function argsort_float_vector
+ * @brief Returns the indices that would sort a vector, leaving it unchanged
+ *
+ * Element i of the result is the index in vec of the i-th value in sorted
+ * order, so vec->data[index[0]] is the smallest value for FORWARD.  The sort
+ * is stable: equal values keep their original relative order.  NaN values
+ * come last in both directions.  Long vectors are ordered with an LSD radix
+ * sort over (key, index) pairs.
+ *
+ * @param vec A float vector or array object
+ * @param direction FORWARD for ascending order, REVERSE for descending
+ * @return A heap array of vec->len indices that the caller must free, or
+ *         NULL.  Sets errno to EINVAL if vec or vec->data is NULL, the length
+ *         is 0 or direction is unknown, or to ENOMEM
+ */
+size_t* argsort_float_vector(const float_v* vec, iter_dir direction);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function apply_permutation_float_vector
+ * @brief Reorders one or more equally long vectors in place
+ *
+ * After the call element i of every vector holds what was at perm[i], so
+ * passing the result of argsort_float_vector sorts the vectors by that key.
+ * The permutation is applied by following its cycles, which moves every
+ * element once and needs only one bit of scratch per element instead of a
+ * copy of the data.
+ *
+ * @param vecs Array of vectors to reorder
+ * @param count Number of vectors in vecs
+ * @param perm A permutation of 0 .. len - 1, where len is the common length
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if any
+ *         pointer is NULL, count is 0, the lengths differ or perm is not a
+ *         permutation (the vectors are left untouched), or to ENOMEM
+ */
+bool apply_permutation_float_vector(float_v** vecs, size_t count, const size_t* perm);
+// -------------------------------------------------------------------------------- 
+
 /**
 * @function trim_float_vector
 * @brief Trims all un-necessary memory from a vector
 *
+* A mapped buffer shrinks in place with mremap and its released pages go
+* back to the kernel.
+*
 * @param vec float vector to trim
 * @return void
 *         Sets errno to EINVAL if vec is NULL or invalid
@@ -312,6 +462,118 @@ void sort_float_vector(float_v* vec, iter_dir direction);
 void trim_float_vector(float_v* vec);
 // -------------------------------------------------------------------------------- 
 
+/**
+ * @function set_float_vector_mmap_threshold
+ * @brief Sets the buffer size from which vectors use anonymous mappings
+ *
+ * A dynamic vector whose buffer reaches this many bytes keeps it in an
+ * anonymous memory mapping instead of a heap block.  The kernel supplies
+ * the pages already zeroed, so growth writes no zeros, and the mapping
+ * grows with mremap, which moves page table entries instead of copying the
+ * data.  A mapping only reserves address space until it is written, so a
+ * mapped vector grows geometrically.  The threshold applies to buffers
+ * allocated after the call; existing buffers keep their kind.  The default
+ * is 32 MiB; 0 maps every buffer and SIZE_MAX none.  Only Linux provides
+ * mremap, so elsewhere every buffer stays on the heap.
+ *
+ * @param bytes Smallest buffer size, in bytes, to map
+ * @return true if successful.  Returns false and sets errno to ENOTSUP on
+ *         platforms without mremap
+ */
+bool set_float_vector_mmap_threshold(size_t bytes);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function float_vector_mmap_threshold
+ * @brief Returns the buffer size from which vectors use anonymous mappings
+ *
+ * @return The threshold in bytes, or SIZE_MAX on platforms without mremap
+ */
+size_t float_vector_mmap_threshold(void);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function set_float_vector_huge_pages
+ * @brief Selects whether new mappings ask for transparent huge pages
+ *
+ * When enabled, which is the default, every new mapped buffer is passed to
+ * madvise with MADV_HUGEPAGE.  Huge pages cut the TLB misses of reductions
+ * over large vectors.  The request is advisory and has no effect where the
+ * kernel does not support it.
+ *
+ * @param enable true to request huge pages
+ */
+void set_float_vector_huge_pages(bool enable);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function is_float_vector_mapped
+ * @brief Returns true if a vector's buffer is an anonymous mapping
+ *
+ * @param vec float vector to query
+ * @return true for a mapped buffer.  Sets errno to EINVAL and returns false
+ *         for NULL input
+ */
+bool is_float_vector_mapped(const float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function open_float_vector_file
+ * @brief Opens a vector stored in a file, mapping the file into memory
+ *
+ * The file holds a 64 byte header (magic, version, byte order mark, len,
+ * alloc, front and a sorted flag) followed by the raw float buffer.  The
+ * whole file is mapped, and the returned vector's data points into the
+ * mapping, so opening costs the same for any size.  Every function that
+ * reads or changes a float_v works on the vector unchanged, and pages are
+ * read from disk only when touched.
+ *
+ * A writable vector uses a MAP_SHARED mapping.  Its changes reach the file
+ * through the page cache; sync_float_vector_file makes them durable.
+ * Growing it extends the file with ftruncate and the mapping with mremap.
+ * A missing or empty file is created with room for 1008 values.
+ *
+ * A read-only vector maps the file privately.  It may still be changed in
+ * memory, but the file is never written and the vector cannot grow past
+ * its stored capacity; such growth fails with EPERM.
+ *
+ * free_float_vector stores the header, unmaps the file and closes it.
+ *
+ * @param path Path of the file
+ * @param writable true to open the file for reading and writing
+ * @return A vector backed by the file, or NULL.  Sets errno from open,
+ *         fstat, ftruncate or mmap; to EINVAL if path is NULL or the file is
+ *         not a vector file of this version and byte order; ENOMEM; or
+ *         ENOTSUP on platforms without mremap
+ */
+float_v* open_float_vector_file(const char* path, bool writable);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function sync_float_vector_file
+ * @brief Writes a file-backed vector's header and data to disk
+ *
+ * Stores the length, capacity and sorted flag in the header, then calls
+ * msync with MS_SYNC.  Does nothing for a read-only vector.
+ *
+ * @param vec A vector returned by open_float_vector_file
+ * @return true if successful.  Sets errno to EINVAL if vec is not
+ *         file-backed, or from msync
+ */
+bool sync_float_vector_file(float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function is_float_vector_file
+ * @brief Returns true if a vector's buffer is a mapped file
+ *
+ * @param vec float vector to query
+ * @return true for a file-backed vector.  Sets errno to EINVAL and returns
+ *         false for NULL input
+ */
+bool is_float_vector_file(const float_v* vec);
+// -------------------------------------------------------------------------------- 
+
 /**
 * @function binary_search_float_vector
 * @brief Searches a float vector to find the index where a value exists
@@ -319,7 +581,9 @@ void trim_float_vector(float_v* vec);
 * @param vec float vector object
 * @param value The value to search for
 * @param tolerance The float tolerance for finding a value 
-* @param sort_first true if the vector or array needs to be sorted, false otherwise
+* @param sort_first true if the vector or array needs to be sorted, false otherwise.
+*        The sort is skipped when the vector is already known to be sorted, so
+*        repeated searches of an unchanged vector cost O(log n)
 * @return The index where a value exists, LONG_MAX if the value is not in the array.
 *         Sets errno to EINVAL if vec is NULL or invalid, ENODATA if the array is 
 *         not populated
@@ -328,92 +592,859 @@ size_t binary_search_float_vector(float_v* vec, float value, float tolerance, bo
 // -------------------------------------------------------------------------------- 
 
 /**
-* @function update_float_vector
-* @brief Replaces the value of a vector at a specific index
-*
-* @param vec float vector object
-* @param index The index where data will be replaced
-* @param replacement_value The replacement value
-* @return void, Sets errno to EINVAL if vec does not exsist, or ERANGE 
-*         if the index is out of bounds
-*/
-void update_float_vector(float_v* vec, size_t index, float replacement_value);
+* @function is_float_vector_sorted
+* @brief Reports whether a vector is known to be in ascending order
+*
+* The answer comes from the sorted flag that the library maintains, so the
+* call is O(1).  A false result means the order is unknown, not that the
+* vector is unsorted.
+*
+* @param vec float vector object
+* @return true if the vector is sorted in ascending order with NaN values last.
+*         Sets errno to EINVAL and returns false if vec is NULL or invalid
+*/
+bool is_float_vector_sorted(const float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function insert_sorted_float_vector
+* @brief Inserts a value at its place in a sorted vector
+*
+* The slot is found by binary search after any values equal to value, so the
+* vector stays sorted and equal values keep their insertion order.  NaN
+* values are appended.
+*
+* @param vec float vector object that is known to be sorted (or empty)
+* @param value The value to insert
+* @return true if successful, false otherwise.  Sets errno to EINVAL if vec is
+*         NULL, invalid, not known to be sorted or a full STATIC array, or
+*         ENOMEM if the vector cannot grow
+*/
+bool insert_sorted_float_vector(float_v* vec, float value);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function lower_bound_float_vector
+* @brief Finds the first position whose value is not less than value
+*
+* @param vec float vector object that is known to be sorted
+* @param value The value to search for
+* @return A position from 0 to the vector length, where the length means
+*         every value is smaller.  Returns LONG_MAX and sets errno to EINVAL if
+*         vec is NULL, invalid or not known to be sorted, or value is NaN
+*/
+size_t lower_bound_float_vector(const float_v* vec, float value);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function upper_bound_float_vector
+* @brief Finds the first position whose value is greater than value
+*
+* @param vec float vector object that is known to be sorted
+* @param value The value to search for
+* @return A position from 0 to the vector length.  Returns LONG_MAX and sets
+*         errno to EINVAL under the same conditions as lower_bound_float_vector
+*/
+size_t upper_bound_float_vector(const float_v* vec, float value);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function count_range_float_vector
+* @brief Counts the values in the closed range [low, high] of a sorted vector
+*
+* @param vec float vector object that is known to be sorted
+* @param low Lower end of the range
+* @param high Upper end of the range
+* @return The number of values x with low <= x <= high, 0 if low > high.
+*         Returns LONG_MAX and sets errno to EINVAL if vec is NULL, invalid or
+*         not known to be sorted, or low or high is NaN
+*/
+size_t count_range_float_vector(const float_v* vec, float low, float high);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @typedef float_search_index
+ * @brief Opaque read-only search structure built from a sorted float vector
+ *
+ * The values are stored in Eytzinger (breadth-first) order, so the first
+ * levels of the implicit binary tree share a few cache lines.  The nodes
+ * needed four levels further down can be prefetched while the current level
+ * is compared.  Each descent step is a comparison and a shift with no
+ * data-dependent branch.  The index holds its own copy of the data.
+ */
+typedef struct float_search_index float_search_index;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @enum search_query
+ * @brief Query types answered by batch_search_float_index
+ *
+ * @attribute SEARCH_LOWER_BOUND Position of the first value >= the query
+ * @attribute SEARCH_UPPER_BOUND Position of the first value > the query
+ * @attribute SEARCH_TOLERANCE Position of the first value within a tolerance
+ *            of the query, as in search_float_index
+ */
+typedef enum {
+    SEARCH_LOWER_BOUND,
+    SEARCH_UPPER_BOUND,
+    SEARCH_TOLERANCE
+} search_query;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function init_float_search_index
+ * @brief Builds a search index from a vector sorted in ascending order
+ *
+ * @param vec A float vector or array sorted in ascending order without NaN
+ * @return A new search index, or NULL.  Sets errno to EINVAL if vec is NULL,
+ *         unsorted or contains NaN, ENODATA if it is empty, or ENOMEM
+ */
+float_search_index* init_float_search_index(const float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function free_float_search_index
+ * @brief Frees a search index
+ *
+ * @param index The index to free
+ * @return void, Sets errno to EINVAL for NULL input
+ */
+void free_float_search_index(float_search_index* index);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function _free_float_search_index
+ * @brief Helper function for garbage collection of search indices
+ *
+ * Used with FLTIDX_GBC macro for automatic cleanup.
+ *
+ * @param index Double pointer to the index to free
+ * @return void
+ */
+void _free_float_search_index(float_search_index** index);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro FLTIDX_GBC
+     * @brief A macro for enabling automatic cleanup of search index objects.
+     */
+    #define FLTIDX_GBC __attribute__((cleanup(_free_float_search_index)))
+#endif
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function float_search_index_size
+ * @brief Returns the number of values in a search index
+ *
+ * @param index The search index
+ * @return The number of values, or LONG_MAX.  Sets errno to EINVAL for NULL
+ */
+size_t float_search_index_size(const float_search_index* index);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function lower_bound_float_index
+ * @brief Finds the position of the first value that is not less than value
+ *
+ * @param index The search index
+ * @param value The value to search for
+ * @return A position in the sorted data from 0 to the index size, where the
+ *         size means every value is smaller.  Returns LONG_MAX and sets
+ *         errno to EINVAL if index is NULL or value is NaN
+ */
+size_t lower_bound_float_index(const float_search_index* index, float value);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function upper_bound_float_index
+ * @brief Finds the position of the first value that is greater than value
+ *
+ * @param index The search index
+ * @param value The value to search for
+ * @return A position in the sorted data from 0 to the index size.  Returns
+ *         LONG_MAX and sets errno to EINVAL if index is NULL or value is NaN
+ */
+size_t upper_bound_float_index(const float_search_index* index, float value);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function search_float_index
+ * @brief Finds a value within a tolerance, like binary_search_float_vector
+ *
+ * A stored value x matches when fabs(x - value) <= tolerance, which is the
+ * test binary_search_float_vector uses.  When several values match, this
+ * function returns the first of them in sorted order.
+ *
+ * @param index The search index
+ * @param value The value to search for
+ * @param tolerance The float tolerance for finding a value
+ * @return The position of the match in the sorted data, or LONG_MAX if there
+ *         is none.  Sets errno to EINVAL if index is NULL, value or tolerance
+ *         is NaN or tolerance is negative
+ */
+size_t search_float_index(const float_search_index* index, float value, float tolerance);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function batch_search_float_index
+ * @brief Answers one query for every value of a query vector
+ *
+ * Queries are processed in groups that descend the tree in lockstep.  The
+ * memory accesses of a group overlap instead of waiting on each other, which
+ * is much faster than calling the single-query functions in a loop.  NaN
+ * queries produce LONG_MAX without setting errno.
+ *
+ * @param index The search index
+ * @param queries The values to search for
+ * @param query The type of query to answer
+ * @param tolerance The tolerance for SEARCH_TOLERANCE, ignored otherwise
+ * @param results Array of at least queries->len elements that receives the
+ *        answer for each query
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if any
+ *         pointer is NULL, query is unknown, or tolerance is NaN or negative
+ *         for SEARCH_TOLERANCE
+ */
+bool batch_search_float_index(const float_search_index* index, const float_v* queries,
+                              search_query query, float tolerance, size_t* results);
+// -------------------------------------------------------------------------------- 
+
+/**
+* @function update_float_vector
+* @brief Replaces the value of a vector at a specific index
+*
+* @param vec float vector object
+* @param index The index where data will be replaced
+* @param replacement_value The replacement value
+* @return void, Sets errno to EINVAL if vec does not exsist, or ERANGE 
+*         if the index is out of bounds
+*/
+void update_float_vector(float_v* vec, size_t index, float replacement_value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @enum simd_level
+ * @brief Instruction sets available to the vectorized reductions
+ *
+ * The levels are ordered, so a higher level implies support for every
+ * level below it.
+ *
+ * @attribute SIMD_SCALAR Portable C loops with no vector instructions
+ * @attribute SIMD_SSE2 128 bit SSE2 kernels
+ * @attribute SIMD_AVX2 256 bit AVX2 kernels
+ * @attribute SIMD_AVX512 512 bit AVX-512F kernels
+ */
+typedef enum {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512
+} simd_level;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function float_simd_level
+ * @brief Returns the instruction set used by the vector reductions
+ *
+ * The level is detected from the host CPU on first use and may be lowered
+ * by setting the C_FLOAT_SIMD environment variable to scalar, sse2, avx2
+ * or avx512 before the first call.
+ *
+ * @return The active simd_level
+ */
+simd_level float_simd_level(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function set_float_simd_level
+ * @brief Forces the vector reductions onto a specific instruction set
+ *
+ * @param level The instruction set to use
+ * @return true if successful, false otherwise.  Sets errno to EINVAL for an
+ *         unknown level, or ENOTSUP if the host CPU does not support it
+ */
+bool set_float_simd_level(simd_level level);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function min_float_vector 
+ * @brief Returns the minimum value in a vector or array 
+ *
+ * NaN values are skipped, with the same result at every SIMD level.
+ *
+ * @param vec A float vector or array object 
+ * @return The minimum value in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float min_float_vector(float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function max_float_vector 
+ * @brief Returns the maximum value in a vector or array 
+ *
+ * NaN values are skipped, with the same result at every SIMD level.
+ *
+ * @param vec A float vector or array object 
+ * @return The maximum value in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float max_float_vector(float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function sum_float_vector 
+ * @brief Returns the summation of all values in a vector or array
+ *
+ * Uses SUM_PAIRWISE summation.
+ *
+ * @param vec A float vector or array object 
+ * @return The summation of all values in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float sum_float_vector(float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @enum sum_mode
+ * @brief Summation algorithms available to sum_float_vector_ex
+ *
+ * @attribute SUM_NAIVE Plain SIMD accumulation, fastest but error grows with length
+ * @attribute SUM_PAIRWISE SIMD leaves combined pairwise, error grows with log(length)
+ * @attribute SUM_KAHAN SIMD Kahan-Babuska summation with per-lane compensation
+ * @attribute SUM_DOUBLE Values widened to double precision lanes before accumulating
+ */
+typedef enum {
+    SUM_NAIVE,
+    SUM_PAIRWISE,
+    SUM_KAHAN,
+    SUM_DOUBLE
+} sum_mode;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function sum_float_vector_ex 
+ * @brief Returns the summation of all values using a selectable algorithm
+ *
+ * @param vec A float vector or array object 
+ * @param mode The summation algorithm to use
+ * @return The summation of all values in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, if length is 0, or if mode is unknown and returns FLT_MAX
+ */
+float sum_float_vector_ex(const float_v* vec, sum_mode mode);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function average_float_vector 
+ * @brief Returns the average of all values in a vector or array
+ *
+ * @param vec A float vector or array object 
+ * @return The average of all values in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float average_float_vector(float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function stdev_float_vector 
+ * @brief Returns the standard deviation of all values in a vector or array
+ *
+ * @param vec A float vector or array object 
+ * @return The standard deviation of all values in a vector.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float stdev_float_vector(float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @struct float_stats_t
+ * @brief Descriptive statistics gathered in a single pass over a vector
+ *
+ * NaN values are counted in nan_count and excluded from every other field.
+ * Infinities are counted in inf_count, participate in min, max, sum and mean,
+ * and force variance and stdev to INFINITY.  variance and stdev are population
+ * statistics, consistent with stdev_float_vector.
+ */
+typedef struct {
+    size_t count;
+    size_t nan_count;
+    size_t inf_count;
+    float min;
+    float max;
+    float sum;
+    float mean;
+    float variance;
+    float stdev;
+} float_stats_t;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function describe_float_vector
+ * @brief Computes count, min, max, sum, mean, variance and standard deviation
+ *        in one vectorized pass
+ *
+ * @param vec A float vector or array object
+ * @return A float_stats_t record.  Sets errno to EINVAL if vec or vec->data is
+ *         NULL or the length is 0, and to ENODATA if every value is NaN; in
+ *         both cases the floating point fields are FLT_MAX
+ */
+float_stats_t describe_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function set_float_thread_count
+ * @brief Sets the number of threads used by the parallel_* functions
+ *
+ * The worker pool is owned by the library and is not started until the first
+ * parallel call that is large enough to use it.  The calling thread always
+ * takes part, so a count of n starts n - 1 workers.  Changing the count stops
+ * the running pool, after any reduction in progress finishes, and it is
+ * restarted lazily with the new size.  On platforms without POSIX threads
+ * the parallel functions run on the calling thread.
+ *
+ * @param nthreads Number of threads, or 0 to use one per online processor
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if
+ *         nthreads is larger than 1024
+ */
+bool set_float_thread_count(size_t nthreads);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function float_thread_count
+ * @brief Returns the number of threads the parallel_* functions will use
+ *
+ * @return The configured thread count, including the calling thread
+ */
+size_t float_thread_count(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function shutdown_float_thread_pool
+ * @brief Stops and joins the worker threads
+ *
+ * The pool is also stopped at program exit.  A later parallel call starts it
+ * again, so this is only needed to release the threads early.
+ */
+void shutdown_float_thread_pool(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parallel_min_float_vector
+ * @brief Multithreaded version of min_float_vector
+ *
+ * Vectors shorter than about one million elements are reduced on the calling
+ * thread, where the thread hand-off would cost more than it saves.
+ *
+ * @param vec A float vector or array object
+ * @return The minimum value in a vector.  Sets errno to EINVAL if vec or
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float parallel_min_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parallel_max_float_vector
+ * @brief Multithreaded version of max_float_vector
+ *
+ * @param vec A float vector or array object
+ * @return The maximum value in a vector.  Sets errno to EINVAL if vec or
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float parallel_max_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parallel_sum_float_vector
+ * @brief Multithreaded version of sum_float_vector
+ *
+ * The vector is summed in fixed size chunks whose partial sums are combined
+ * pairwise in order, so the result does not depend on the thread count.
+ *
+ * @param vec A float vector or array object
+ * @return The summation of all values in a vector.  Sets errno to EINVAL if vec or
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float parallel_sum_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parallel_average_float_vector
+ * @brief Multithreaded version of average_float_vector
+ *
+ * @param vec A float vector or array object
+ * @return The average of all values in a vector.  Sets errno to EINVAL if vec or
+ *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ */
+float parallel_average_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parallel_stdev_float_vector
+ * @brief Multithreaded version of stdev_float_vector
+ *
+ * @param vec A float vector or array object
+ * @return The standard deviation of all values in a vector.  Sets errno to
+ *         ENODATA if vec or vec->data is NULL or the length is less than 2
+ *         and returns FLT_MAX
+ */
+float parallel_stdev_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @enum scan_op
+ * @brief Operators available to the prefix scan functions
+ *
+ * @attribute SCAN_SUM Running sum, accumulated in double precision
+ * @attribute SCAN_PROD Running product, accumulated in double precision
+ * @attribute SCAN_MIN Running minimum; NaN values are skipped
+ * @attribute SCAN_MAX Running maximum; NaN values are skipped
+ */
+typedef enum {
+    SCAN_SUM,
+    SCAN_PROD,
+    SCAN_MIN,
+    SCAN_MAX
+} scan_op;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function scan_float_vector
+ * @brief Writes the inclusive prefix scan of src into dst
+ *
+ * Element i of dst becomes op applied to src[0] through src[i].  dst may be
+ * the same vector as src, in which case the scan runs in place.  A dynamic
+ * dst that is too small is grown; its length is set to the length of src.
+ * Sums and products follow IEEE rules, so NaN and infinities propagate.
+ *
+ * @param src The vector to scan
+ * @param dst The vector that receives the result, or src itself
+ * @param op The scan operator
+ * @return true if successful, false otherwise.  Sets errno to EINVAL if either
+ *         vector or its data is NULL, src is empty, op is unknown or a static
+ *         dst is too small, or to ENOMEM if dst cannot be grown
+ */
+bool scan_float_vector(const float_v* src, float_v* dst, scan_op op);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function parallel_scan_float_vector
+ * @brief Multithreaded version of scan_float_vector
+ *
+ * Large vectors are scanned in two passes: every chunk is scanned on its own
+ * in parallel, then each chunk is offset by the combined totals of the chunks
+ * before it.  Sums and products can differ from scan_float_vector in the last
+ * bit because each chunk offset is applied after the chunk was rounded to
+ * float.  The chunking does not depend on the thread count, and neither
+ * does the result.  Short vectors are scanned on the calling thread.
+ *
+ * @param src The vector to scan
+ * @param dst The vector that receives the result, or src itself
+ * @param op The scan operator
+ * @return true if successful, false otherwise.  Sets errno as scan_float_vector
+ */
+bool parallel_scan_float_vector(const float_v* src, float_v* dst, scan_op op);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cum_sum_float_vector 
+ * @brief Returns a dynamically allocated array containing the cumulative sum of all 
+ *        values in vec
+ *
+ * Once the running sum overflows, every remaining element is INFINITY.  Use
+ * scan_float_vector with SCAN_SUM for plain IEEE semantics.
+ *
+ * @param vec A float vector or array object 
+ * @return A float_v object with the cumulative sum of all values in vec.  Sets errno to EINVAL if vec or 
+ *         vec-data is NULL, if length is 0, or if vec contains NaN and returns NULL
+ */
+float_v* cum_sum_float_vector(float_v* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function cum_prod_float_vector
+ * @brief Returns a dynamically allocated vector containing the cumulative
+ *        product of all values in vec
+ *
+ * @param vec A float vector or array object
+ * @return A float_v object with the cumulative product, or NULL.  Sets errno
+ *         to EINVAL if vec or vec->data is NULL or the length is 0, or ENOMEM
+ */
+float_v* cum_prod_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cum_min_float_vector
+ * @brief Returns a dynamically allocated vector containing the running minimum
+ *        of vec
+ *
+ * NaN values are skipped; positions before the first number hold INFINITY.
+ *
+ * @param vec A float vector or array object
+ * @return A float_v object with the running minimum, or NULL.  Sets errno
+ *         to EINVAL if vec or vec->data is NULL or the length is 0, or ENOMEM
+ */
+float_v* cum_min_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function cum_max_float_vector
+ * @brief Returns a dynamically allocated vector containing the running maximum
+ *        of vec
+ *
+ * NaN values are skipped; positions before the first number hold -INFINITY.
+ *
+ * @param vec A float vector or array object
+ * @return A float_v object with the running maximum, or NULL.  Sets errno
+ *         to EINVAL if vec or vec->data is NULL or the length is 0, or ENOMEM
+ */
+float_v* cum_max_float_vector(const float_v* vec);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief creates a deep copy of a vector
+ *
+ * @param original A vector to be copied 
+ * @return A copy of a float vector
+ */
+float_v* copy_float_vector(const float_v* original);
+// ================================================================================ 
+// ================================================================================ 
+// SEGMENTED VECTOR PROTOTYPES 
+
+/**
+ * @typedef float_sv
+ * @brief Opaque growable float container stored in fixed-size chunks
+ *
+ * Elements live in chunks of a power-of-two size reached through a chunk
+ * directory.  Appending never moves an element: a full vector gains one
+ * chunk and only the directory of chunk pointers is ever reallocated.
+ * Appends therefore cost O(1) even for multi-gigabyte streams, and a
+ * pointer returned by float_seg_vector_ptr stays valid until the vector is
+ * freed.  Reductions run the SIMD kernels over each chunk in turn, and
+ * flatten_float_seg_vector copies the data into a contiguous float_v when
+ * an API needs one.
+ */
+typedef struct float_sv float_sv;
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function init_float_seg_vector
+ * @brief Creates an empty segmented vector
+ *
+ * @param chunk_size Elements per chunk, rounded up to a power of two of at
+ *        least 16.  0 selects the default of 65536 elements (256 KiB)
+ * @return A new segmented vector, or NULL.  Sets errno to EINVAL if
+ *         chunk_size is too large, or ENOMEM
+ */
+float_sv* init_float_seg_vector(size_t chunk_size);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function free_float_seg_vector
+ * @brief Frees a segmented vector and all of its chunks
+ *
+ * @param vec The vector to free
+ * @return void, Sets errno to EINVAL for NULL input
+ */
+void free_float_seg_vector(float_sv* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function _free_float_seg_vector
+ * @brief Helper function for garbage collection of segmented vectors
+ *
+ * Used with FLTSEG_GBC macro for automatic cleanup.
+ *
+ * @param vec Double pointer to the vector to free
+ * @return void
+ */
+void _free_float_seg_vector(float_sv** vec);
+// --------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined (__clang__)
+    /**
+     * @macro FLTSEG_GBC
+     * @brief A macro for enabling automatic cleanup of segmented vectors.
+     */
+    #define FLTSEG_GBC __attribute__((cleanup(_free_float_seg_vector)))
+#endif
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function push_back_float_seg_vector
+ * @brief Appends a value, adding a chunk when the last one is full
+ *
+ * @param vec Target segmented vector
+ * @param value Value to append
+ * @return true if successful, false on error.  Sets errno to EINVAL for
+ *         NULL input or ENOMEM if a chunk cannot be allocated
+ */
+bool push_back_float_seg_vector(float_sv* vec, float value);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function append_float_seg_vector
+ * @brief Appends count values, copying them a chunk at a time
+ *
+ * @param vec Target segmented vector
+ * @param values Array of at least count values
+ * @param count Number of values to append
+ * @return true if successful, false on error.  Sets errno to EINVAL for
+ *         NULL input or ENOMEM.  Values copied before an allocation failure
+ *         stay in the vector
+ */
+bool append_float_seg_vector(float_sv* vec, const float* values, size_t count);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function pop_back_float_seg_vector
+ * @brief Removes and returns the last value
+ *
+ * The chunk that held the value is kept for later appends.
+ *
+ * @param vec Source segmented vector
+ * @return The removed value, or FLT_MAX.  Sets errno to EINVAL for NULL
+ *         input or ENODATA if the vector is empty
+ */
+float pop_back_float_seg_vector(float_sv* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function float_seg_vector_index
+ * @brief Returns the value at an index
+ *
+ * @param vec Source segmented vector
+ * @param index Position of the value
+ * @return The value, or FLT_MAX.  Sets errno to EINVAL for NULL input or
+ *         ERANGE if index is out of bounds
+ */
+float float_seg_vector_index(const float_sv* vec, size_t index);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function float_seg_vector_ptr
+ * @brief Returns the address of the value at an index
+ *
+ * The address stays valid until the vector is freed, however much it grows.
+ *
+ * @param vec Source segmented vector
+ * @param index Position of the value
+ * @return Pointer to the value, or NULL.  Sets errno to EINVAL for NULL input
+ *         or ERANGE if index is out of bounds
+ */
+float* float_seg_vector_ptr(float_sv* vec, size_t index);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function float_seg_vector_size
+ * @brief Returns the number of values in a segmented vector
+ *
+ * @param vec Segmented vector to query
+ * @return Number of values, or LONG_MAX.  Sets errno to EINVAL for NULL
+ */
+size_t float_seg_vector_size(const float_sv* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function float_seg_vector_alloc
+ * @brief Returns the number of values the allocated chunks can hold
+ *
+ * @param vec Segmented vector to query
+ * @return Capacity, or LONG_MAX.  Sets errno to EINVAL for NULL
+ */
+size_t float_seg_vector_alloc(const float_sv* vec);
 // -------------------------------------------------------------------------------- 
 
 /**
- * @function min_float_vector 
- * @brief Returns the minimum value in a vector or array 
+ * @function float_seg_vector_chunk_size
+ * @brief Returns the number of values per chunk
  *
- * @param vec A float vector or array object 
- * @return The minimum value in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * @param vec Segmented vector to query
+ * @return Chunk size, or LONG_MAX.  Sets errno to EINVAL for NULL
  */
-float min_float_vector(float_v* vec);
+size_t float_seg_vector_chunk_size(const float_sv* vec);
 // -------------------------------------------------------------------------------- 
 
 /**
- * @function max_float_vector 
- * @brief Returns the maximum value in a vector or array 
+ * @function float_seg_vector_chunks
+ * @brief Returns the number of chunks that hold values
  *
- * @param vec A float vector or array object 
- * @return The maximum value in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * @param vec Segmented vector to query
+ * @return Chunk count, or LONG_MAX.  Sets errno to EINVAL for NULL
  */
-float max_float_vector(float_v* vec);
+size_t float_seg_vector_chunks(const float_sv* vec);
 // -------------------------------------------------------------------------------- 
 
 /**
- * @function sum_float_vector 
- * @brief Returns the summation of all values in a vector or array
+ * @function float_seg_vector_chunk
+ * @brief Returns one chunk as a contiguous array
  *
- * @param vec A float vector or array object 
- * @return The summation of all values in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * Together with float_seg_vector_chunks this lets callers run their own
+ * kernels over the data chunk by chunk without copying it.
+ *
+ * @param vec Segmented vector to query
+ * @param chunk Chunk number, below float_seg_vector_chunks(vec)
+ * @param len Receives the number of values in the chunk
+ * @return The values of the chunk, or NULL.  Sets errno to EINVAL for NULL
+ *         input or ERANGE if chunk is out of bounds
  */
-float sum_float_vector(float_v* vec);
+const float* float_seg_vector_chunk(const float_sv* vec, size_t chunk, size_t* len);
 // -------------------------------------------------------------------------------- 
 
 /**
- * @function average_float_vector 
- * @brief Returns the average of all values in a vector or array
+ * @function min_float_seg_vector
+ * @brief Returns the minimum value, skipping NaN as min_float_vector does
  *
- * @param vec A float vector or array object 
- * @return The average of all values in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * @param vec Segmented vector to query
+ * @return The minimum, or FLT_MAX.  Sets errno to EINVAL for NULL or empty input
  */
-float average_float_vector(float_v* vec);
+float min_float_seg_vector(const float_sv* vec);
 // -------------------------------------------------------------------------------- 
 
 /**
- * @function stdev_float_vector 
- * @brief Returns the standard deviation of all values in a vector or array
+ * @function max_float_seg_vector
+ * @brief Returns the maximum value, skipping NaN as max_float_vector does
  *
- * @param vec A float vector or array object 
- * @return The standard deviation of all values in a vector.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * @param vec Segmented vector to query
+ * @return The maximum, or FLT_MAX.  Sets errno to EINVAL for NULL or empty input
  */
-float stdev_float_vector(float_v* vec);
+float max_float_seg_vector(const float_sv* vec);
 // -------------------------------------------------------------------------------- 
 
 /**
- * @function cum_sum_float_vector 
- * @brief Returns a dynamically allocated array containing the cumulative sum of all 
- *        values in vec
+ * @function sum_float_seg_vector
+ * @brief Returns the sum of all values
  *
- * @param vec A float vector or array object 
- * @return A float_v object with the cumulative sum of all values in vec.  Sets errno to EINVAL if vec or 
- *         vec-data is NULL, or if length is 0 and returns FLT_MAX
+ * Each chunk is summed with the kernel selected by mode, as in
+ * sum_float_vector_ex, and the chunk sums are accumulated in double.
+ *
+ * @param vec Segmented vector to query
+ * @param mode Summation algorithm used within each chunk
+ * @return The sum, or FLT_MAX.  Sets errno to EINVAL for NULL or empty input
+ *         or an unknown mode
  */
-float_v* cum_sum_float_vector(float_v* vec);
+float sum_float_seg_vector(const float_sv* vec, sum_mode mode);
 // -------------------------------------------------------------------------------- 
 
 /**
- * @brief creates a deep copy of a vector
+ * @function average_float_seg_vector
+ * @brief Returns the mean of all values, using pairwise sums within chunks
  *
- * @param original A vector to be copied 
- * @return A copy of a float vector
+ * @param vec Segmented vector to query
+ * @return The mean, or FLT_MAX.  Sets errno to EINVAL for NULL or empty input
  */
-float_v* copy_float_vector(const float_v* original);
+float average_float_seg_vector(const float_sv* vec);
+// -------------------------------------------------------------------------------- 
+
+/**
+ * @function flatten_float_seg_vector
+ * @brief Copies a segmented vector into a new contiguous float vector
+ *
+ * @param vec Segmented vector to copy
+ * @return A float_v whose capacity equals its length, or NULL.  Sets errno
+ *         to EINVAL for NULL input, ENODATA if vec is empty, or ENOMEM
+ */
+float_v* flatten_float_seg_vector(const float_sv* vec);
 // ================================================================================ 
 // ================================================================================ 
 // DICTIONARY PROTOTYPES 
@@ -428,14 +1459,216 @@ float_v* copy_float_vector(const float_v* original);
 typedef struct dict_f dict_f;
 // --------------------------------------------------------------------------------
 
+/**
+ * @enum dict_backend
+ * @brief Hash table engines available to dict_f
+ *
+ * Both engines keep the entries themselves in one dense array in insertion
+ * order; the engine decides how keys are mapped to positions in it.
+ *
+ * @attribute DICT_OPEN Open addressing with SIMD probing.  A slot array
+ *            holds entry positions and a control byte per slot holds seven
+ *            bits of the key's hash, so a lookup compares 16 slots per SSE2
+ *            instruction and rarely reads a key that does not match.  Deleted
+ *            slots become tombstones that are reclaimed when the table is
+ *            rebuilt.  This is the default.
+ * @attribute DICT_CHAINED Separate chaining, with the entries of a bucket
+ *            linked through their positions.  The original engine, kept for
+ *            comparison and as a fallback
+ */
+typedef enum {
+    DICT_OPEN,
+    DICT_CHAINED
+} dict_backend;
+// --------------------------------------------------------------------------------
+
+/**
+ * @typedef dict_hash_fn
+ * @brief Hash function used by dict_f and dict_fv
+ *
+ * Receives a key, its length in bytes without the terminator, and the
+ * dictionary's seed.  The result may depend only on those three values.
+ * The engines take table positions from the bits above the lowest seven, so
+ * every input bit should affect every result bit.
+ */
+typedef size_t (*dict_hash_fn)(const char* key, size_t len, uint64_t seed);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief 64-bit wyhash, the default hash of dict_f and dict_fv
+ *
+ * Keys of up to 16 bytes are hashed with a few overlapping loads and one
+ * 64 x 64 -> 128 bit multiply.  Longer keys are consumed 48 bytes per step
+ * by three independent multiply chains.  Reads are unaligned-safe.
+ *
+ * @param key Key bytes
+ * @param len Number of bytes to hash
+ * @param seed Seed mixed into the result
+ * @return The hash, or 0 if key is NULL
+ */
+size_t c_float_hash_wy(const char* key, size_t len, uint64_t seed);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief 32-bit MurmurHash3, the hash the dictionaries used originally
+ *
+ * Processes four bytes per step.  The 64-bit seed is folded to 32 bits.
+ * Only the low 32 bits of the result vary, which limits how well very large
+ * tables are spread, so this is kept mainly for comparison.
+ *
+ * @param key Key bytes
+ * @param len Number of bytes to hash
+ * @param seed Seed mixed into the result
+ * @return The hash, or 0 if key is NULL
+ */
+size_t c_float_hash_murmur3(const char* key, size_t len, uint64_t seed);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns a fresh random seed for a dictionary hash function.
+ *
+ * Draws from the kernel where it can, otherwise from a process-wide counter
+ * mixed with the clock.  This is the source init_float_dict uses.
+ *
+ * @return A 64 bit seed
+ */
+uint64_t c_float_random_seed(void);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Initializes a new dictionary.
  *
- * Allocates and initializes a dictionary object with a default size for the hash table.
+ * Allocates and initializes a dictionary object with a default size for the
+ * hash table, using the DICT_OPEN engine.
  *
  * @return A pointer to the newly created dictionary, or NULL if allocation fails.
  */
-dict_f* init_float_dict();
+dict_f* init_float_dict(void);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a new dictionary that uses a specific hash table engine.
+ *
+ * Every dict_f function works with either engine.  Copies and merges use the
+ * engine of their (first) source.
+ *
+ * @param backend The hash table engine
+ * @return A pointer to the newly created dictionary, or NULL.  Sets errno to
+ *         EINVAL for an unknown backend and ENOMEM if allocation fails
+ */
+dict_f* init_float_dict_ex(dict_backend backend);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the hash table engine of a dictionary.
+ *
+ * @param dict Pointer to the dictionary.
+ * @return The engine.  Sets errno to EINVAL and returns DICT_OPEN for NULL
+ */
+dict_backend float_dict_backend(const dict_f* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Selects the hash function and seed of a dictionary.
+ *
+ * A new dictionary uses c_float_hash_wy with a random seed drawn for that
+ * dictionary alone, so an attacker who can choose keys cannot precompute a
+ * set that collides.  Fixing the seed makes table layout reproducible, for
+ * example in tests.  Existing entries are hashed again and the table is
+ * rebuilt at its current size; their insertion order is kept.  Copies keep
+ * the hash and seed of their source.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param hash The hash function, such as c_float_hash_wy or a custom one
+ * @param seed The seed passed to every call of hash
+ * @return true on success.  Sets errno to EINVAL and returns false if dict or
+ *         hash is NULL
+ */
+bool set_float_dict_hash(dict_f* dict, dict_hash_fn hash, uint64_t seed);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the seed of a dictionary's hash function.
+ *
+ * @param dict Pointer to the dictionary.
+ * @return The seed.  Sets errno to EINVAL and returns 0 for NULL
+ */
+uint64_t float_dict_seed(const dict_f* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Turns incremental resizing on or off.
+ *
+ * A normal resize moves every entry to the new table inside the insert that
+ * triggered it.  In incremental mode the old and new tables coexist after a
+ * resize.  Each later insert, pop or update moves a small, fixed number of
+ * old buckets or slots, so no single call pays for the whole table.  Lookups
+ * search both tables but never move entries, so const functions stay safe
+ * for concurrent readers.  Turning the mode off finishes any pending resize.
+ * Copies and merges inherit the mode of their (first) source.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param incremental true to spread resizes over later mutations
+ * @return true on success.  Sets errno to EINVAL and returns false for NULL
+ */
+bool set_float_dict_incremental(dict_f* dict, bool incremental);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Reports whether an incremental resize is still in progress.
+ *
+ * @param dict Pointer to the dictionary.
+ * @return true while entries remain in the old table.  Sets errno to EINVAL
+ *         and returns false for NULL
+ */
+bool is_float_dict_rehashing(const dict_f* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a DICT_OPEN dictionary sized for a known number of keys.
+ *
+ * The first capacity inserts never resize the table.
+ *
+ * @param capacity Number of entries the table must hold without growing
+ * @return A pointer to the new dictionary, or NULL.  Sets errno to ENOMEM if
+ *         allocation fails
+ */
+dict_f* init_float_dict_with_capacity(size_t capacity);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Grows the table so it holds capacity entries without resizing.
+ *
+ * The table is never shrunk.  A dictionary in incremental mode starts an
+ * incremental resize, like any other growth.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param capacity Total number of entries, existing ones included
+ * @return true on success.  Sets errno to EINVAL for NULL and ENOMEM if the
+ *         table cannot be allocated, and returns false
+ */
+bool reserve_float_dict(dict_f* dict, size_t capacity);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Inserts n key-value pairs with a single up-front resize.
+ *
+ * The table is reserved for the existing entries plus n before the first
+ * insert.  Keys are then hashed in batches, and the first group or bucket of
+ * every key in a batch is prefetched before any of them is inserted.  A key
+ * that is already present, or that repeats within keys, keeps the value it
+ * already has and is not counted.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param keys Array of n keys
+ * @param values Array of n values, values[i] belongs to keys[i]
+ * @param n Number of pairs
+ * @return Number of keys inserted.  Returns SIZE_MAX and sets errno to EINVAL
+ *         if dict, keys, values or any key is NULL (nothing is inserted), or
+ *         to ENOMEM if allocation fails part way (earlier pairs stay inserted)
+ */
+size_t insert_many_float_dict(dict_f* dict, const char* const keys[], const float values[],
+                              size_t n);
 // --------------------------------------------------------------------------------
 
 /**
@@ -478,6 +1711,28 @@ float pop_float_dict(dict_f* dict,  const char* key);
 float get_float_dict_value(const dict_f* dict, const char* key);
 // --------------------------------------------------------------------------------
 
+/**
+ * @brief Looks up n keys at once, overlapping their cache misses.
+ *
+ * Keys are resolved in batches.  For every key in a batch the query string,
+ * its first group or bucket, the entry that points to and that entry's key
+ * are prefetched in successive passes, so the cache misses of the batch
+ * overlap.  The results match n calls to get_float_dict_value.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param keys Array of n keys
+ * @param n Number of keys
+ * @param out_values Receives the value of keys[i] in out_values[i], or FLT_MAX
+ *        if the key is missing
+ * @param out_found Optional.  When not NULL, out_found[i] is set to whether
+ *        keys[i] is present
+ * @return Number of keys found.  Returns SIZE_MAX and sets errno to EINVAL if
+ *         dict, keys, out_values or any key is NULL; nothing is written then
+ */
+size_t get_many_float_dict(const dict_f* dict, const char* const keys[], size_t n,
+                           float out_values[], bool out_found[]);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Frees the memory associated with the dictionary.
  *
@@ -524,10 +1779,58 @@ void _free_float_dict(dict_f** dict);
 bool update_float_dict(dict_f* dict, const char* key, float value);
 // --------------------------------------------------------------------------------
 
+/**
+ * @brief Inserts a key or overwrites its value.
+ *
+ * Hashes the key once and makes a single pass over its probe path or chain.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to insert or update.
+ * @param value The value to store.
+ * @return true on success.  Sets errno to EINVAL for NULL input and ENOMEM
+ *         if allocation fails, and returns false
+ */
+bool upsert_float_dict(dict_f* dict, const char* key, float value);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Adds delta to the value of a key, inserting it if missing.
+ *
+ * A missing key counts as zero, so it is inserted with value delta.  Hashes
+ * the key once and makes a single pass over its probe path or chain, which
+ * makes it suited to counters and other read-modify-write loops.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to accumulate into.
+ * @param delta The amount to add.
+ * @return true on success.  Sets errno to EINVAL for NULL input and ENOMEM
+ *         if allocation fails, and returns false
+ */
+bool add_to_float_dict(dict_f* dict, const char* key, float delta);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the value slot of a key, inserting value first if missing.
+ *
+ * Hashes the key once and makes a single pass over its probe path or chain.
+ * The caller may read and write through the pointer.  It stays valid until
+ * the next call that inserts into, removes from, updates, clears or frees
+ * the dictionary.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param key The key to look up or insert.
+ * @param value The value a newly inserted key starts with.
+ * @return Pointer to the stored value, or NULL.  Sets errno to EINVAL for
+ *         NULL input and ENOMEM if allocation fails
+ */
+float* get_or_insert_float_dict(dict_f* dict, const char* key, float value);
+// --------------------------------------------------------------------------------
+
 /**
  * @brief Gets the number of non-empty buckets in the dictionary.
  *
  * Returns the total number of buckets in the hash table that contain at least one key-value pair.
+ * A DICT_OPEN table holds one entry per slot, so this equals the number of entries.
  *
  * @param dict Pointer to the dictionary.
  * @return The number of non-empty buckets.
@@ -538,7 +1841,9 @@ size_t float_dict_size(const dict_f* dict);
 /**
  * @brief Gets the total capacity of the dictionary.
  *
- * Returns the total number of buckets currently allocated in the hash table.
+ * Returns the total number of buckets (slots for DICT_OPEN) currently allocated
+ * in the hash table.
+ * During an incremental resize this is the size of the new table.
  *
  * @param dict Pointer to the dictionary.
  * @return The total number of buckets in the dictionary.
@@ -570,6 +1875,10 @@ bool has_key_float_dict(const dict_f* dict, const char* key);
 /**
  * @brief Creates a deep copy of a dictionary
  * 
+ * The copy keeps the source's engine, table size, entry positions, resize
+ * mode and any pending incremental resize.  Keys are copied with memcpy into
+ * one slab and are never rehashed or checked for duplicates.
+ *
  * @param dict Pointer to the dictionary to copy
  * @return dict_f* New dictionary containing copies of all entries, NULL on error
  */
@@ -596,6 +1905,9 @@ string_v* get_keys_float_dict(const dict_f* dict);
 
 /**
  * @brief Gets all values in the dictionary
+ *
+ * The values come in insertion order, matching get_keys_float_dict, and are
+ * copied in one block.  float_dict_values gives the same data without a copy.
  * 
  * @param dict Pointer to the dictionary
  * @return float* Array containing all values, NULL on error
@@ -621,12 +1933,64 @@ typedef void (*dict_iterator)(const char* key, float value, void* user_data);
 
 /**
  * @brief Iterates over all dictionary entries in insertion order
+ *
+ * Entries are stored densely, so this is a linear scan.  Removing a key
+ * moves the most recently inserted entry into its position.
  * 
  * @param dict Pointer to the dictionary
  * @param iter Iterator function to call for each entry
  * @param user_data Optional user data passed to iterator function
  */
 bool foreach_float_dict(const dict_f* dict, dict_iterator iter, void* user_data);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Returns a read-only view of the dictionary's values
+ *
+ * The values are one contiguous array of float_dict_hash_size(dict)
+ * elements in the same order as foreach_float_dict and
+ * get_keys_float_dict.  The view is borrowed: it is not copied and stays
+ * valid until the next call that inserts into, removes from, clears or frees
+ * the dictionary.
+ *
+ * @param dict Pointer to the dictionary
+ * @return Pointer to the first value.  Sets errno to EINVAL and returns NULL
+ *         if dict is NULL
+ */
+const float* float_dict_values(const dict_f* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Sums the values of a dictionary
+ *
+ * Runs the pairwise SIMD summation of sum_float_vector directly over the
+ * dictionary's value array, without copying it.
+ *
+ * @param dict Pointer to the dictionary
+ * @return The sum of all values.  Sets errno to EINVAL and returns FLT_MAX
+ *         if dict is NULL or empty
+ */
+float sum_float_dict(const dict_f* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Finds the smallest value in a dictionary
+ *
+ * @param dict Pointer to the dictionary
+ * @return The minimum value.  Sets errno to EINVAL and returns FLT_MAX if
+ *         dict is NULL or empty
+ */
+float min_float_dict(const dict_f* dict);
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Finds the largest value in a dictionary
+ *
+ * @param dict Pointer to the dictionary
+ * @return The maximum value.  Sets errno to EINVAL and returns FLT_MAX if
+ *         dict is NULL or empty
+ */
+float max_float_dict(const dict_f* dict);
 // ================================================================================ 
 // ================================================================================
 // VECTOR DICTIONARY PROTOTYPES 
@@ -649,6 +2013,22 @@ typedef struct dict_fv dict_fv;
 dict_fv* init_floatv_dict(void);
 // -------------------------------------------------------------------------------- 
 
+/**
+ * @brief Selects the hash function and seed of a vector dictionary.
+ *
+ * Works like set_float_dict_hash.  A new dictionary uses c_float_hash_wy
+ * with a seed of its own, so keys crafted to collide in one dictionary do
+ * not collide in another; pass a fixed seed here for a reproducible layout.
+ *
+ * @param dict Pointer to the dictionary.
+ * @param hash The hash function
+ * @param seed The seed passed to every call of hash
+ * @return true on success.  Sets errno to EINVAL and returns false if dict or
+ *         hash is NULL
+ */
+bool set_floatv_dict_hash(dict_fv* dict, dict_hash_fn hash, uint64_t seed);
+// -------------------------------------------------------------------------------- 
+
 /**
 * @function create_floatv_dict
 * @brief Creates a key vector/array pair 
@@ -772,6 +2152,9 @@ size_t float_dictv_hash_size(const dict_fv* dict);
 /**
  * @brief Creates a deep copy of a vector float dictionary 
  *
+ * Chains are rebuilt in the same buckets and order, with keys copied into one
+ * slab and never rehashed.  Every vector is copied with copy_float_vector.
+ *
  * @param original A float vector dictionary 
  * @return A copy of a dictionary
  */
@@ -825,6 +2208,132 @@ bool foreach_floatv_dict(const dict_fv* dict, dict_fv_iterator iter, void* user_
 string_v* get_keys_floatv_dict(const dict_fv* dict);
 // ================================================================================ 
 // ================================================================================ 
+// BINARY STORAGE
+
+/**
+ * @enum load_mode
+ * @brief How a stored container is brought into memory
+ *
+ * @attribute LOAD_READ Reads the floats straight into memory the
+ *            container owns
+ * @attribute LOAD_MAP Maps the file privately and returns views of the
+ *            mapped floats, which are paged in as they are touched
+ */
+typedef enum {
+    LOAD_READ,
+    LOAD_MAP
+} load_mode;
+// --------------------------------------------------------------------------------
+
+/**
+ * @function save_float_vector
+ * @brief Writes a vector to a file in the binary storage format
+ *
+ * A stored file holds a 64 byte header (magic, version, byte order mark,
+ * container kind, flags, entry count, hash seed, data offset, file length
+ * and a checksum), a table of fixed size entries, a table of NUL terminated
+ * keys, and the float data starting on a 64 byte boundary.  A vector has no
+ * entries or keys, so its floats follow the header directly.  The checksum
+ * covers everything after the header.  The data is written to a temporary
+ * file beside path, synced and renamed over path, so an existing file is
+ * replaced atomically and a failed save leaves it untouched.
+ *
+ * @param vec Vector to store
+ * @param path Path of the file
+ * @return true if successful.  Sets errno to EINVAL for NULL input, or
+ *         from mkstemp, fwrite, fsync, fclose or rename
+ */
+bool save_float_vector(const float_v* vec, const char* path);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function load_float_vector
+ * @brief Loads a vector written by save_float_vector
+ *
+ * With LOAD_READ the file is read straight into the new vector's buffer,
+ * with no copy or parsing afterwards.  With LOAD_MAP the vector is a view of
+ * the floats in a private mapping of the file: it may be changed in memory
+ * without touching the file, but it cannot grow, which fails with EPERM.
+ * copy_float_vector returns a vector that can.  free_float_vector unmaps the
+ * file.  An empty vector has nothing to view and is loaded as an ordinary
+ * vector.
+ *
+ * @param path Path of the file
+ * @param mode LOAD_READ or LOAD_MAP
+ * @param verify true to check the checksum, which reads the whole file
+ * @return The vector, or NULL.  Sets errno to EINVAL if an argument is
+ *         invalid or the file is not a stored vector of this version and
+ *         byte order, EIO if the checksum does not match, ENOMEM, ENOTSUP
+ *         for LOAD_MAP on platforms without mremap, or from fopen or mmap
+ */
+float_v* load_float_vector(const char* path, load_mode mode, bool verify);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function save_float_dict
+ * @brief Writes a dictionary to a file in the binary storage format
+ *
+ * Each entry records its key's offset, length and hash.  The values are
+ * stored as one float array in insertion order.  The header records the
+ * backend and, for the default hash, the seed, so a loader places every
+ * key by its stored hash instead of hashing it.
+ *
+ * @param dict Dictionary to store
+ * @param path Path of the file
+ * @return true if successful.  Sets errno to EINVAL for NULL input, or
+ *         from mkstemp, fwrite, fsync, fclose or rename
+ */
+bool save_float_dict(const dict_f* dict, const char* path);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function load_float_dict
+ * @brief Loads a dictionary written by save_float_dict
+ *
+ * The dictionary keeps the stored backend and insertion order.  With
+ * LOAD_MAP its keys and values stay in the mapping; the values move to the
+ * heap the first time the dictionary grows.  A dictionary stored with a
+ * custom hash function is loaded with c_float_hash_wy and a new seed.
+ *
+ * @param path Path of the file
+ * @param mode LOAD_READ or LOAD_MAP
+ * @param verify true to check the checksum, which reads the whole file
+ * @return The dictionary, or NULL.  Sets errno as load_float_vector does
+ */
+dict_f* load_float_dict(const char* path, load_mode mode, bool verify);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function save_floatv_dict
+ * @brief Writes a vector dictionary to a file in the binary storage format
+ *
+ * Each entry records its key and the offset and length of its vector.
+ * Every vector starts on a 64 byte boundary.
+ *
+ * @param dict Dictionary to store
+ * @param path Path of the file
+ * @return true if successful.  Sets errno to EINVAL for NULL input, or
+ *         from mkstemp, fwrite, fsync, fclose or rename
+ */
+bool save_floatv_dict(const dict_fv* dict, const char* path);
+// --------------------------------------------------------------------------------
+
+/**
+ * @function load_floatv_dict
+ * @brief Loads a vector dictionary written by save_floatv_dict
+ *
+ * With LOAD_MAP every vector is a view into one shared mapping, as
+ * load_float_vector describes, and the mapping is released with the last
+ * of them.
+ *
+ * @param path Path of the file
+ * @param mode LOAD_READ or LOAD_MAP
+ * @param verify true to check the checksum, which reads the whole file
+ * @return The dictionary, or NULL.  Sets errno as load_float_vector does
+ */
+dict_fv* load_floatv_dict(const char* path, load_mode mode, bool verify);
+// ================================================================================ 
+// ================================================================================ 
 // GENERIC MACROS
 
 /**
@@ -844,6 +2353,7 @@ string_v* get_keys_floatv_dict(const dict_fv* dict);
  */
 #define f_size(f_struct) _Generic((f_struct), \
     float_v*: float_vector_size, \
+    float_sv*: float_seg_vector_size, \
     dict_f*: float_dict_size, \
     dict_fv*: float_dictv_size) (f_struct)
 // --------------------------------------------------------------------------------
@@ -865,6 +2375,7 @@ string_v* get_keys_floatv_dict(const dict_fv* dict);
  */
 #define f_alloc(f_struct) _Generic((f_struct), \
     float_v*: float_vector_alloc, \
+    float_sv*: float_seg_vector_alloc, \
     dict_f*: float_dict_alloc, \
     dict_fv*: float_dictv_alloc) (f_struct)
 // ================================================================================ 
@@ -20,6 +20,13 @@
 #include <string.h> // For strerror
 #include <limits.h> // For INT_MIN
 #include <ctype.h>  // For isspace
+#include <stdint.h> // For uint64_t
+#include <time.h>   // For time and clock, seeding dictionaries
+
+// Dictionary seeds come from the kernel where it offers a call for them
+#if defined(__linux__)
+    #include <sys/random.h>
+#endif
 // ================================================================================ 
 // ================================================================================
 
@@ -1650,6 +1657,7 @@ string_v* tokenize_string(const string_t* str, const char* delim) {
 typedef struct dictNode {
     char* key;
     float value;
+    size_t hash;  // Cached so resizing never hashes a key again
     struct dictNode* next;
 } dictNode;
 // --------------------------------------------------------------------------------
@@ -1659,18 +1667,121 @@ struct dict_t {
     size_t hash_size;
     size_t len;
     size_t alloc;
+    uint64_t seed;  // Per-dictionary, so keys chosen to collide elsewhere do not collide here
 };
 // --------------------------------------------------------------------------------
 
-static size_t hash_function(const char* key) {
-    size_t hash = 5381; // Initialize hash with a prime number
-    int c;
-
-    while ((c = *key++)) { // Iterate over each character in the key
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+static inline uint64_t _read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --------------------------------------------------------------------------------
+
+static inline void _wymum(uint64_t* a, uint64_t* b) {
+    // Full 64 x 64 -> 128 bit product, low half in a and high half in b
+#if defined(__SIZEOF_INT128__)
+    __extension__ unsigned __int128 r = (unsigned __int128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    const uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+// --------------------------------------------------------------------------------
+
+static inline uint64_t _wymix(uint64_t a, uint64_t b) {
+    _wymum(&a, &b);
+    return a ^ b;
+}
+// --------------------------------------------------------------------------------
+
+/**
+ * @brief Hashes a key of known length with 64-bit wyhash
+ *
+ * Reads the key eight or four bytes at a time instead of one, with
+ * unaligned-safe loads.  The same algorithm backs the c_float dictionaries;
+ * it is repeated here so this file still builds on its own.
+ */
+static size_t hash_function(const dict_t* dict, const char* key, size_t len) {
+    static const uint64_t p0 = 0x2d358dccaa6c78a5ull, p1 = 0x8bb84b93962eacc9ull,
+                          p2 = 0x4b33a62ed433d4a3ull, p3 = 0x4d5a2da51de1aa47ull;
+    const unsigned char* p = (const unsigned char*)key;
+    uint64_t seed = dict->seed ^ _wymix(dict->seed ^ p0, p1);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            const size_t shift = (len >> 3) << 2;
+            a = (_read32(p) << 32) | _read32(p + shift);
+            b = (_read32(p + len - 4) << 32) | _read32(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = _wymix(_read64(p) ^ p1, _read64(p + 8) ^ seed);
+                see1 = _wymix(_read64(p + 16) ^ p2, _read64(p + 24) ^ see1);
+                see2 = _wymix(_read64(p + 32) ^ p3, _read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = _wymix(_read64(p) ^ p1, _read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = _read64(p + i - 16);
+        b = _read64(p + i - 8);
     }
+    a ^= p1;
+    b ^= seed;
+    _wymum(&a, &b);
+    return (size_t)_wymix(a ^ p0 ^ len, b ^ p1);
+}
+// --------------------------------------------------------------------------------
 
-    return hash; // Return the computed hash value
+static uint64_t _dict_seed(const void* owner) {
+    // The kernel supplies the seed where it can; otherwise a process-wide
+    // counter is mixed with the clock and the dictionary's address
+#if defined(__linux__)
+    uint64_t random;
+    if (getrandom(&random, sizeof(random), GRND_NONBLOCK) == (ssize_t)sizeof(random)) {
+        return random;
+    }
+#endif
+    static uint64_t counter;
+#if defined(__GNUC__) || defined(__clang__)
+    uint64_t x = __atomic_add_fetch(&counter, 0x9e3779b97f4a7c15ull, __ATOMIC_RELAXED);
+#else
+    uint64_t x = counter += 0x9e3779b97f4a7c15ull;
+#endif
+    x ^= (uint64_t)time(NULL) ^ ((uint64_t)(uintptr_t)owner << 16) ^ (uint64_t)clock();
+    // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
 }
 // --------------------------------------------------------------------------------
 
@@ -1694,7 +1805,7 @@ static bool resize_dict(dict_t* dict, size_t new_size) {
         dictNode* current = dict->keyValues[i].next;
         while (current) {
             dictNode* next = current->next;
-            size_t new_index = hash_function(current->key) % new_size;
+            size_t new_index = current->hash % new_size;
             
             // Insert at front of new chain
             current->next = new_table[new_index].next;
@@ -1739,6 +1850,7 @@ dict_t* init_dict() {
     hashPtr->hash_size = 0;
     hashPtr->len = 0;
     hashPtr->alloc = hashSize;
+    hashPtr->seed = _dict_seed(hashPtr);
     return hashPtr;
 }
 // --------------------------------------------------------------------------------
@@ -1758,12 +1870,13 @@ bool insert_dict(dict_t* dict, const char* key, size_t value) {
         }
     }
     
-    size_t index = hash_function(key) % dict->alloc;
+    const size_t hash = hash_function(dict, key, strlen(key));
+    size_t index = hash % dict->alloc;
     
     // Check for existing key while finding insertion point
     dictNode* current = dict->keyValues[index].next;
     while (current) {
-        if (strcmp(current->key, key) == 0) {
+        if (current->hash == hash && strcmp(current->key, key) == 0) {
             errno = EINVAL;
             return false;  // Key already exists
         }
@@ -1785,6 +1898,7 @@ bool insert_dict(dict_t* dict, const char* key, size_t value) {
     }
     
     new_node->value = value;
+    new_node->hash = hash;
     new_node->next = dict->keyValues[index].next;
     dict->keyValues[index].next = new_node;
     
@@ -1800,13 +1914,14 @@ size_t pop_dict(dict_t* dict, char* key) {
         errno = EINVAL;
         return LONG_MAX;
     }
-    size_t index = hash_function(key) % dict->alloc;
+    const size_t hash = hash_function(dict, key, strlen(key));
+    size_t index = hash % dict->alloc;
 
     // Traverse the linked list at the index
     dictNode* prev = &dict->keyValues[index];
     dictNode* current = prev->next;
     while (current) {
-        if (strcmp(current->key, key) == 0) {
+        if (current->hash == hash && strcmp(current->key, key) == 0) {
             // Key found, unlink the node from the linked list
             prev->next = current->next;
             
@@ -1836,11 +1951,12 @@ const size_t get_dict_value(const dict_t* table, char* key) {
         errno = EINVAL;
         return LONG_MAX;
     }
-    size_t index = hash_function(key) % table->alloc;
+    const size_t hash = hash_function(table, key, strlen(key));
+    size_t index = hash % table->alloc;
     // Traverse the linked list at the index
     dictNode* current = table->keyValues[index].next;
     while (current) {
-        if (strcmp(current->key, key) == 0) {
+        if (current->hash == hash && strcmp(current->key, key) == 0) {
             // Key found, return the corresponding value
             return current->value;
         }
@@ -1879,10 +1995,11 @@ bool update_dict(dict_t* dict, char* key, size_t value) {
         errno = EINVAL;
         return false;
     }
-    size_t index = hash_function(key) % dict->alloc;
+    const size_t hash = hash_function(dict, key, strlen(key));
+    size_t index = hash % dict->alloc;
     dictNode* current = dict->keyValues[index].next;
     while (current) {
-        if (strcmp(current->key, key) == 0) {
+        if (current->hash == hash && strcmp(current->key, key) == 0) {
             current->value = value;
             return true;
         }
@@ -1927,11 +2044,12 @@ bool is_key_value(const dict_t* dict, const char* key) {
         return false;
     }
     
-    size_t index = hash_function(key) % dict->alloc;
+    const size_t hash = hash_function(dict, key, strlen(key));
+    size_t index = hash % dict->alloc;
     dictNode* current = dict->keyValues[index].next;
     
     while (current) {
-        if (strcmp(current->key, key) == 0) {
+        if (current->hash == hash && strcmp(current->key, key) == 0) {
             return true;  // Key exists
         }
         current = current->next;
@@ -141,6 +141,24 @@ void test_pop_front_special_values(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_pop_front_static(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_pop_front_fifo_window(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_push_front_deque(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_deque_matches_reference(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_mapped_vector_growth(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_file_vector_roundtrip(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_file_vector_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -186,6 +204,36 @@ void test_sort_static_array(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_sort_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sort_modes_agree(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sort_nan_last(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sort_ex_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_parallel_sort_matches_serial(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_parallel_sort_duplicates(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_parallel_sort_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_argsort_basic(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_argsort_radix_stable(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_apply_permutation(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_argsort_permutation_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -218,6 +266,27 @@ void test_binary_search_errors(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_binary_search_static(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_search_index_bounds(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_search_index_tolerance(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_search_index_batch(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_search_index_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sorted_flag_tracking(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_insert_sorted(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sorted_range_queries(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -244,6 +313,15 @@ void test_min_max_static_array(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_min_max_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_simd_levels_agree(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_simd_stdev_infinity(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_simd_level_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -263,6 +341,18 @@ void test_sum_average_static(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_sum_average_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sum_modes_basic(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sum_modes_accuracy(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sum_modes_infinity(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_sum_modes_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -285,6 +375,49 @@ void test_stdev_cum_sum_special_values(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_stdev_cum_sum_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_describe_basic(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_describe_special_values(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_describe_levels_agree(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_describe_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_parallel_reductions_basic(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_parallel_thread_counts_agree(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_parallel_reductions_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_scan_levels_agree(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_scan_in_place_and_prod(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_parallel_scan(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_scan_errors(void **state);
+// ================================================================================ 
+// ================================================================================ 
+
+void test_seg_vector_push_and_index(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_seg_vector_append_and_reduce(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_seg_vector_errors(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -343,6 +476,72 @@ void test_foreach_float_dict_null(void** state);
 // -------------------------------------------------------------------------------- 
 
 void test_dictionary_gbc(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_backends_agree(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_open_churn(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_backend_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_dict_prefix_keys(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_incremental_resize(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_incremental_clear(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_dict_arena_long_keys(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_dict_arena_churn(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_upsert(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_add_to(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_merge_float_dict_flt_max(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_reserve(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_insert_many_float_dict(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_copy_float_dict_structural(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_copy_floatv_dict_structural(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_values_view(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_swap_remove_order(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_get_many_float_dict(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_hash_vectors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_set_float_dict_hash(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_float_dict_seeds_differ(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_set_floatv_dict_hash(void **state);
 // ================================================================================ 
 // ================================================================================ 
 
@@ -415,6 +614,21 @@ void test_foreach_floatv_dict_with_null_callback(void **state);
 // -------------------------------------------------------------------------------- 
 
 void test_foreach_floatv_dict_accumulates_sum(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_store_float_vector(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_store_float_dict(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_store_floatv_dict(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_store_errors(void **state);
+// -------------------------------------------------------------------------------- 
+
+void test_store_atomic_save(void **state);
 // ================================================================================ 
 // ================================================================================ 
 #endif /* test_H */
@@ -64,6 +64,12 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_pop_front_errors),
     cmocka_unit_test(test_pop_front_special_values),
     cmocka_unit_test(test_pop_front_static),
+    cmocka_unit_test(test_pop_front_fifo_window),
+    cmocka_unit_test(test_push_front_deque),
+    cmocka_unit_test(test_deque_matches_reference),
+    cmocka_unit_test(test_mapped_vector_growth),
+    cmocka_unit_test(test_file_vector_roundtrip),
+    cmocka_unit_test(test_file_vector_errors),
     cmocka_unit_test(test_pop_any_basic),
     cmocka_unit_test(test_pop_any_errors),
     cmocka_unit_test(test_pop_any_static),
@@ -78,6 +84,16 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_sort_special_values),
     cmocka_unit_test(test_sort_static_array),
     cmocka_unit_test(test_sort_errors),
+    cmocka_unit_test(test_sort_modes_agree),
+    cmocka_unit_test(test_sort_nan_last),
+    cmocka_unit_test(test_sort_ex_errors),
+    cmocka_unit_test(test_parallel_sort_matches_serial),
+    cmocka_unit_test(test_parallel_sort_duplicates),
+    cmocka_unit_test(test_parallel_sort_errors),
+    cmocka_unit_test(test_argsort_basic),
+    cmocka_unit_test(test_argsort_radix_stable),
+    cmocka_unit_test(test_apply_permutation),
+    cmocka_unit_test(test_argsort_permutation_errors),
     cmocka_unit_test(test_trim_basic),
     cmocka_unit_test(test_trim_empty_vector),
     cmocka_unit_test(test_trim_static_array),
@@ -88,6 +104,13 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_binary_search_with_sort),
     cmocka_unit_test(test_binary_search_errors),
     cmocka_unit_test(test_binary_search_static),
+    cmocka_unit_test(test_search_index_bounds),
+    cmocka_unit_test(test_search_index_tolerance),
+    cmocka_unit_test(test_search_index_batch),
+    cmocka_unit_test(test_search_index_errors),
+    cmocka_unit_test(test_sorted_flag_tracking),
+    cmocka_unit_test(test_insert_sorted),
+    cmocka_unit_test(test_sorted_range_queries),
     cmocka_unit_test(test_update_float_vector_nominal),
     cmocka_unit_test(test_update_float_vector_bad_index),
     cmocka_unit_test(test_update_float_vector_null),
@@ -96,19 +119,40 @@ const struct CMUnitTest test_vector[] = {
     cmocka_unit_test(test_min_max_special_values),
     cmocka_unit_test(test_min_max_static_array),
     cmocka_unit_test(test_min_max_errors),
+    cmocka_unit_test(test_simd_levels_agree),
+    cmocka_unit_test(test_simd_stdev_infinity),
+    cmocka_unit_test(test_simd_level_errors),
     cmocka_unit_test(test_sum_basic),
     cmocka_unit_test(test_average_basic),
     cmocka_unit_test(test_sum_average_special_values),
     cmocka_unit_test(test_sum_average_negative),
     cmocka_unit_test(test_sum_average_static),
     cmocka_unit_test(test_sum_average_errors),
+    cmocka_unit_test(test_sum_modes_basic),
+    cmocka_unit_test(test_sum_modes_accuracy),
+    cmocka_unit_test(test_sum_modes_infinity),
+    cmocka_unit_test(test_sum_modes_errors),
     cmocka_unit_test(test_stdev_basic),
     cmocka_unit_test(test_stdev_single_value),
     cmocka_unit_test(test_stdev_same_values),
     cmocka_unit_test(test_cum_sum_basic),
     cmocka_unit_test(test_cum_sum_negative),
     cmocka_unit_test(test_stdev_cum_sum_special_values),
-    cmocka_unit_test(test_stdev_cum_sum_errors)
+    cmocka_unit_test(test_stdev_cum_sum_errors),
+    cmocka_unit_test(test_describe_basic),
+    cmocka_unit_test(test_describe_special_values),
+    cmocka_unit_test(test_describe_levels_agree),
+    cmocka_unit_test(test_describe_errors),
+    cmocka_unit_test(test_parallel_reductions_basic),
+    cmocka_unit_test(test_parallel_thread_counts_agree),
+    cmocka_unit_test(test_parallel_reductions_errors),
+    cmocka_unit_test(test_scan_levels_agree),
+    cmocka_unit_test(test_scan_in_place_and_prod),
+    cmocka_unit_test(test_parallel_scan),
+    cmocka_unit_test(test_scan_errors),
+    cmocka_unit_test(test_seg_vector_push_and_index),
+    cmocka_unit_test(test_seg_vector_append_and_reduce),
+    cmocka_unit_test(test_seg_vector_errors)
 };
 // -------------------------------------------------------------------------------- 
 
@@ -129,6 +173,28 @@ const struct CMUnitTest test_dict[] = {
     cmocka_unit_test_setup_teardown(test_foreach_float_dict_basic, setup, teardown),
     cmocka_unit_test_setup_teardown(test_foreach_float_dict_empty, setup, teardown),
     cmocka_unit_test_setup_teardown(test_foreach_float_dict_null, setup, teardown),
+    cmocka_unit_test(test_float_dict_backends_agree),
+    cmocka_unit_test(test_float_dict_open_churn),
+    cmocka_unit_test(test_float_dict_backend_errors),
+    cmocka_unit_test(test_dict_prefix_keys),
+    cmocka_unit_test(test_float_dict_incremental_resize),
+    cmocka_unit_test(test_float_dict_incremental_clear),
+    cmocka_unit_test(test_dict_arena_long_keys),
+    cmocka_unit_test(test_dict_arena_churn),
+    cmocka_unit_test(test_float_dict_upsert),
+    cmocka_unit_test(test_float_dict_add_to),
+    cmocka_unit_test(test_merge_float_dict_flt_max),
+    cmocka_unit_test(test_float_dict_reserve),
+    cmocka_unit_test(test_insert_many_float_dict),
+    cmocka_unit_test(test_copy_float_dict_structural),
+    cmocka_unit_test(test_copy_floatv_dict_structural),
+    cmocka_unit_test(test_float_dict_values_view),
+    cmocka_unit_test(test_float_dict_swap_remove_order),
+    cmocka_unit_test(test_get_many_float_dict),
+    cmocka_unit_test(test_float_dict_hash_vectors),
+    cmocka_unit_test(test_set_float_dict_hash),
+    cmocka_unit_test(test_float_dict_seeds_differ),
+    cmocka_unit_test(test_set_floatv_dict_hash),
     cmocka_unit_test(test_vector_dictionary),
     cmocka_unit_test(test_vector_dictionary_resize),
     cmocka_unit_test(test_vector_dictionary_gbc),
@@ -152,6 +218,11 @@ const struct CMUnitTest test_dict[] = {
     cmocka_unit_test(test_foreach_floatv_dict_with_null_dict),
     cmocka_unit_test(test_foreach_floatv_dict_with_null_callback),
     cmocka_unit_test(test_foreach_floatv_dict_accumulates_sum),
+    cmocka_unit_test(test_store_float_vector),
+    cmocka_unit_test(test_store_float_dict),
+    cmocka_unit_test(test_store_floatv_dict),
+    cmocka_unit_test(test_store_errors),
+    cmocka_unit_test(test_store_atomic_save),
 };
 // ================================================================================ 
 // ================================================================================ 